@@ -145,9 +145,11 @@ struct db_main *ldr_init_test_db(struct fmt_main *format, struct db_main *real)
 				format->params.salt_align);
 			current_salt->index = fmt_dummy_hash;
 			current_salt->bitmap = NULL;
+			current_salt->filter = NULL;
 			current_salt->list = NULL;
 			current_salt->hash = &current_salt->list;
 			current_salt->hash_size = -1;
+			current_salt->packed_start = NULL;
 			current_salt->count = 0;
 			testdb->salt_count++;
 		}
@@ -97,6 +97,16 @@ static int64 *crk_timestamps;
 static char crk_stdout_key[PLAINTEXT_BUFFER_SIZE];
 int64_t crk_pot_pos;
 
+/*
+ * The salts indexed by sequential_id (which follows their order in the list),
+ * with tombstones (NULLs) for those removed.  For a tombstone, crk_salt_link[]
+ * holds the id of a salt that preceded it (or -1), and these links are
+ * compressed as they're followed, so that crk_remove_salt() can find the
+ * predecessor of a salt without walking the list from its head.
+ */
+static struct db_salt **crk_salt_by_id;
+static int *crk_salt_link;
+
 static void crk_dummy_set_salt(void *salt)
 {
 }
@@ -113,6 +123,47 @@ static void crk_init_salt(void)
 	}
 }
 
+static void crk_init_salt_ids(void)
+{
+	struct db_salt *salt;
+	int count = 0;
+
+	MEM_FREE(crk_salt_by_id);
+	MEM_FREE(crk_salt_link);
+
+	for (salt = crk_db->salts; salt; salt = salt->next)
+		if (salt->sequential_id != count++)
+			return;
+	if (count < 2)
+		return;
+
+	crk_salt_by_id = mem_alloc(count * sizeof(*crk_salt_by_id));
+	crk_salt_link = mem_alloc(count * sizeof(*crk_salt_link));
+	for (salt = crk_db->salts; salt; salt = salt->next) {
+		crk_salt_by_id[salt->sequential_id] = salt;
+		crk_salt_link[salt->sequential_id] = salt->sequential_id;
+	}
+}
+
+/*
+ * Returns the closest salt still in the list before the one with this id.
+ */
+static struct db_salt *crk_salt_before(int id)
+{
+	int live, next;
+
+	live = id - 1;
+	while (live >= 0 && !crk_salt_by_id[live])
+		live = crk_salt_link[live];
+
+	for (id--; id > live; id = next) {
+		next = crk_salt_link[id];
+		crk_salt_link[id] = live;
+	}
+
+	return live >= 0 ? crk_salt_by_id[live] : NULL;
+}
+
 static void crk_help(void)
 {
 	static int printed = 0;
@@ -188,7 +239,10 @@ void crk_init(struct db_main *db, void (*fix_state)(void),
 	}
 #endif
 
-	if (db->loaded) crk_init_salt();
+	if (db->loaded) {
+		crk_init_salt();
+		crk_init_salt_ids();
+	}
 	crk_last_key = crk_key_index = 0;
 	crk_last_salt = NULL;
 
@@ -222,11 +276,18 @@ void crk_init(struct db_main *db, void (*fix_state)(void),
  */
 static void crk_remove_salt(struct db_salt *salt)
 {
-	struct db_salt **current;
+	struct db_salt **current, *prev;
+	int id = salt->sequential_id;
 
 	crk_db->salt_count--;
 
 	current = &crk_db->salts;
+	if (crk_salt_by_id && crk_salt_by_id[id] == salt) {
+		crk_salt_by_id[id] = NULL;
+		crk_salt_link[id] = id - 1;
+		if ((prev = crk_salt_before(id)))
+			current = &prev->next;
+	}
 	while (*current != salt)
 		current = &(*current)->next;
 	*current = salt->next;
@@ -251,6 +312,39 @@ static void crk_remove_salt(struct db_salt *salt)
 	dyna_salt_remove(salt->salt);
 }
 
+/*
+ * crk_remove_packed() is called by crk_remove_hash() for salts using a packed
+ * hash table.  The entry is marked as removed in place, so that the positions
+ * of other entries (possibly prefetched already) remain valid.  Returns the
+ * number of entries with this exact hash value that were present.
+ */
+static int crk_remove_packed(struct db_salt *salt, struct db_password *pw,
+	int hash)
+{
+	unsigned int *start = &salt->packed_start[hash >> PASSWORD_HASH_SHR];
+	unsigned int index, i;
+	int count = 1, others = 0;
+
+	index = ((char *)pw->binary - (char *)salt->packed_binary) /
+	    crk_db->packed_size;
+
+	for (i = start[0]; i < start[1]; i++) {
+		if (i == index || !salt->packed_pw[i])
+			continue;
+		others++;
+		if (crk_db->format->methods.binary_hash[salt->hash_size]
+		    ((char *)salt->packed_binary + i * crk_db->packed_size) ==
+		    hash)
+			count++;
+	}
+
+/* As in crk_remove_hash(), skip the write if the bitmap will do */
+	if (others)
+		salt->packed_pw[index] = NULL;
+
+	return count;
+}
+
 /*
  * Updates the database after a password has been cracked.
  */
@@ -282,24 +376,30 @@ static void crk_remove_hash(struct db_salt *salt, struct db_password *pw)
 
 	hash = crk_db->format->methods.binary_hash[salt->hash_size](pw->binary);
 	count = 0;
-	start = current = &salt->hash[hash >> PASSWORD_HASH_SHR];
-	do {
-		if (crk_db->format->methods.binary_hash[salt->hash_size]
-		    ((*current)->binary) == hash)
-			count++;
-		if (*current == pw) {
+
+	if (salt->packed_start)
+		count = crk_remove_packed(salt, pw, hash);
+	else {
+		start = current = &salt->hash[hash >> PASSWORD_HASH_SHR];
+		do {
+			if (crk_db->format->methods.binary_hash[salt->hash_size]
+			    ((*current)->binary) == hash)
+				count++;
+			if (*current == pw) {
 /*
  * If we can, skip the write to hash table to avoid unnecessary page
  * copy-on-write when running with "--fork".  We can do this when we're about
  * to remove this entry from the bitmap, which we'd be checking first.
  */
-			if (count == 1 && current == start && !pw->next_hash)
-				break;
-			*current = pw->next_hash;
-		} else {
-			current = &(*current)->next_hash;
-		}
-	} while (*current);
+				if (count == 1 && current == start &&
+				    !pw->next_hash)
+					break;
+				*current = pw->next_hash;
+			} else {
+				current = &(*current)->next_hash;
+			}
+		} while (*current);
+	}
 
 	assert(count >= 1);
 
@@ -431,6 +531,10 @@ static int crk_process_guess(struct db_salt *salt, struct db_password *pw,
 		}
 	}
 
+/* Have loopback mode try it along with what it got from the pot file */
+	if (index >= 0 && crk_db->loopback && !options.secure)
+		ldr_loopback_add(crk_db, key);
+
 	if (!(crk_params.flags & FMT_NOT_EXACT))
 		crk_remove_hash(salt, pw);
 
@@ -561,6 +665,27 @@ static int crk_remove_pot_entry(char *ciphertext)
 		      (1U << (hash % (sizeof(*salt->bitmap) * 8)))))
 			return 0;
 
+		if (salt->packed_start) {
+			unsigned int *start =
+			    &salt->packed_start[hash >> PASSWORD_HASH_SHR];
+			unsigned int i;
+
+			for (i = start[0]; i < start[1]; i++) {
+				char *source;
+
+				if (!(pw = salt->packed_pw[i]))
+					continue;
+				source = crk_methods.source(pw->source,
+				    pw->binary);
+				if (!strcmp(source, ciphertext)) {
+					if (crk_process_guess(salt, pw, -1))
+						return 1;
+
+					if (!(crk_db->options->flags & DB_WORDS))
+						break;
+				}
+			}
+		} else
 		if ((pw = salt->hash[hash >> PASSWORD_HASH_SHR]))
 		do {
 			char *source;
@@ -597,6 +722,8 @@ int crk_reload_pot(void)
 	if (crk_params.flags & FMT_NOT_EXACT)
 		return 0;
 
+	log_wait(); /* for crk_pot_pos to account for our own writes */
+
 	if (!(pot_file = fopen(path_expand(options.activepot), "rb")))
 		pexit("fopen: %s", path_expand(options.activepot));
 
@@ -794,48 +921,146 @@ void crk_set_hybrid_fix_state_func_ptr(fix_state_fp fp)
 	fp_fix_state = fp;
 }
 
-static int crk_password_loop(struct db_salt *salt)
+/*
+ * Whether a computed hash can be rejected with the salt's first-level bitmap
+ * alone.  When it can, the prefetching loops point at crk_no_bits instead of
+ * the real bitmap, so that it's not touched at all.
+ */
+#define CRK_FILTERED(salt, h) \
+	((salt)->filter && !((salt)->filter[((h) & (salt)->filter_mask) / \
+	    (sizeof(*(salt)->filter) * 8)] & \
+	    (1U << ((h) % (sizeof(*(salt)->filter) * 8)))))
+
+#if CRK_PREFETCH
+static unsigned int crk_no_bits;
+#endif
+
+/*
+ * The part of crk_password_loop() for salts with a packed hash table.  Since
+ * removed entries stay in place (just marked), nothing we've prefetched can
+ * go stale here.
+ */
+static int crk_packed_loop(struct db_salt *salt, unsigned int first,
+	unsigned int match)
 {
-	int count;
-	unsigned int match, index;
+	struct db_password *pw;
+	size_t size = crk_db->packed_size;
+	unsigned int index, i, *start;
 #if CRK_PREFETCH
 	unsigned int target;
-#endif
 
-#if !OS_TIMER
-	sig_timer_emu_tick();
+	for (index = first; index < match; index = target) {
+		unsigned int slot, ahead, lucky;
+		struct {
+			unsigned int i;
+			unsigned int *p;
+		} a[CRK_PREFETCH];
+		target = index + crk_prefetch;
+		if (target > match)
+			target = match;
+		for (slot = 0, ahead = index; ahead < target; slot++, ahead++) {
+			unsigned int h = salt->index(ahead);
+			unsigned int *b = &salt->bitmap[h / (sizeof(*salt->bitmap) * 8)];
+			a[slot].i = h;
+			if (CRK_FILTERED(salt, h)) {
+				a[slot].p = &crk_no_bits;
+				continue;
+			}
+			a[slot].p = b;
+#ifdef __SSE__
+			_mm_prefetch((const char *)b, _MM_HINT_NTA);
+#else
+			*(volatile unsigned int *)b;
 #endif
-
-	idle_yield();
-
-	if (event_pending && crk_process_event())
-		return -1;
-
-	if (fp_fix_state)
-		fp_fix_state();
-
-	count = crk_key_index;
-	match = crk_methods.crypt_all(&count, salt);
-	crk_last_key = count;
-
-	{
-		int64 effective_count;
-		mul32by32(&effective_count, salt->count, count);
-		status_update_crypts(&effective_count, count);
+		}
+		lucky = 0;
+		for (slot = 0, ahead = index; ahead < target; slot++, ahead++) {
+			unsigned int h = a[slot].i;
+			if (*a[slot].p & (1U << (h % (sizeof(*salt->bitmap) * 8)))) {
+				start = &salt->packed_start[h >> PASSWORD_HASH_SHR];
+#ifdef __SSE__
+				_mm_prefetch((const char *)start, _MM_HINT_NTA);
+#else
+				*(volatile unsigned int *)start;
+#endif
+				a[lucky].i = ahead;
+				a[lucky++].p = start;
+			}
+		}
+		if (!lucky)
+			continue;
+		for (slot = 0; slot < lucky; slot++) {
+			const char *binary = (char *)salt->packed_binary +
+			    (size_t)*a[slot].p * size;
+#ifdef __SSE__
+			_mm_prefetch(binary, _MM_HINT_NTA);
+#else
+			*(volatile char *)binary;
+#endif
+		}
+		for (slot = 0; slot < lucky; slot++) {
+			start = a[slot].p;
+			index = a[slot].i;
+			for (i = start[0]; i < start[1]; i++) {
+				void *binary = (char *)salt->packed_binary +
+				    (size_t)i * size;
+				if (!(pw = salt->packed_pw[i]))
+					continue;
+				if (crk_methods.cmp_one(binary, index))
+				if (crk_methods.cmp_exact(crk_methods.source(
+				    pw->source, binary), index))
+				if (crk_process_guess(salt, pw, index - first))
+					return 1;
+			}
+		}
+	}
+#else
+	for (index = first; index < match; index++) {
+		unsigned int hash = salt->index(index);
+		if (!CRK_FILTERED(salt, hash) &&
+		    salt->bitmap[hash / (sizeof(*salt->bitmap) * 8)] &
+		    (1U << (hash % (sizeof(*salt->bitmap) * 8)))) {
+			start = &salt->packed_start[hash >> PASSWORD_HASH_SHR];
+			for (i = start[0]; i < start[1]; i++) {
+				void *binary = (char *)salt->packed_binary +
+				    (size_t)i * size;
+				if (!(pw = salt->packed_pw[i]))
+					continue;
+				if (crk_methods.cmp_one(binary, index))
+				if (crk_methods.cmp_exact(crk_methods.source(
+				    pw->source, binary), index))
+				if (crk_process_guess(salt, pw, index - first))
+					return 1;
+			}
+		}
 	}
+#endif
 
-	if (!match)
-		return 0;
+	return 0;
+}
+
+/*
+ * Checks the crypt_all() outputs with indices first to match - 1 against the
+ * salt's hashes.  first is non-zero for all but the first salt processed with
+ * crypt_all_salts(), in which case cmp_all() can't be used.
+ */
+static int crk_match_loop(struct db_salt *salt, unsigned int first,
+	unsigned int match)
+{
+	unsigned int index;
+#if CRK_PREFETCH
+	unsigned int target;
+#endif
 
 	if (!salt->bitmap) {
 		struct db_password *pw = salt->list;
 		do {
-			if (crk_methods.cmp_all(pw->binary, match))
-			for (index = 0; index < match; index++)
+			if (first || crk_methods.cmp_all(pw->binary, match))
+			for (index = first; index < match; index++)
 			if (crk_methods.cmp_one(pw->binary, index))
 			if (crk_methods.cmp_exact(crk_methods.source(
 			    pw->source, pw->binary), index)) {
-				if (crk_process_guess(salt, pw, index))
+				if (crk_process_guess(salt, pw, index - first))
 					return 1;
 				else {
 					if (!(crk_params.flags & FMT_NOT_EXACT))
@@ -847,8 +1072,11 @@ static int crk_password_loop(struct db_salt *salt)
 		return 0;
 	}
 
+	if (salt->packed_start)
+		return crk_packed_loop(salt, first, match);
+
 #if CRK_PREFETCH
-	for (index = 0; index < match; index = target) {
+	for (index = first; index < match; index = target) {
 		unsigned int slot, ahead, lucky;
 		struct {
 			unsigned int i;
@@ -864,6 +1092,10 @@ static int crk_password_loop(struct db_salt *salt)
 			unsigned int h = salt->index(ahead);
 			unsigned int *b = &salt->bitmap[h / (sizeof(*salt->bitmap) * 8)];
 			a[slot].i = h;
+			if (CRK_FILTERED(salt, h)) {
+				a[slot].u.b = &crk_no_bits;
+				continue;
+			}
 			a[slot].u.b = b;
 #ifdef __SSE__
 			_mm_prefetch((const char *)b, _MM_HINT_NTA);
@@ -909,7 +1141,7 @@ static int crk_password_loop(struct db_salt *salt)
 				if (crk_methods.cmp_one(pw->binary, index))
 				if (crk_methods.cmp_exact(crk_methods.source(
 				    pw->source, pw->binary), index)) {
-					if (crk_process_guess(salt, pw, index))
+					if (crk_process_guess(salt, pw, index - first))
 						return 1;
 /* After we've successfully cracked and removed a hash, our prefetched bitmap
  * and hash table entries might be stale: some might correspond to the same
@@ -931,9 +1163,10 @@ static int crk_password_loop(struct db_salt *salt)
 		}
 	}
 #else
-	for (index = 0; index < match; index++) {
+	for (index = first; index < match; index++) {
 		unsigned int hash = salt->index(index);
-		if (salt->bitmap[hash / (sizeof(*salt->bitmap) * 8)] &
+		if (!CRK_FILTERED(salt, hash) &&
+		    salt->bitmap[hash / (sizeof(*salt->bitmap) * 8)] &
 		    (1U << (hash % (sizeof(*salt->bitmap) * 8)))) {
 			struct db_password *pw =
 			    salt->hash[hash >> PASSWORD_HASH_SHR];
@@ -941,7 +1174,7 @@ static int crk_password_loop(struct db_salt *salt)
 				if (crk_methods.cmp_one(pw->binary, index))
 				if (crk_methods.cmp_exact(crk_methods.source(
 				    pw->source, pw->binary), index))
-				if (crk_process_guess(salt, pw, index))
+				if (crk_process_guess(salt, pw, index - first))
 					return 1;
 			} while ((pw = pw->next_hash));
 		}
@@ -951,6 +1184,88 @@ static int crk_password_loop(struct db_salt *salt)
 	return 0;
 }
 
+static int crk_password_loop(struct db_salt *salt)
+{
+	int count;
+	unsigned int match;
+
+#if !OS_TIMER
+	sig_timer_emu_tick();
+#endif
+
+	idle_yield();
+
+	if (event_pending && crk_process_event())
+		return -1;
+
+	if (fp_fix_state)
+		fp_fix_state();
+
+	count = crk_key_index;
+	match = crk_methods.crypt_all(&count, salt);
+	crk_last_key = count;
+
+	{
+		int64 effective_count;
+		mul32by32(&effective_count, salt->count, count);
+		status_update_crypts(&effective_count, count);
+	}
+
+	if (!match)
+		return 0;
+
+	return crk_match_loop(salt, 0, match);
+}
+
+/*
+ * Like crk_password_loop(), but for a block of salts starting with *salt,
+ * using the format's crypt_all_salts() method.  *salt is updated to the last
+ * salt processed.
+ */
+static int crk_salts_loop(struct db_salt **salt)
+{
+	struct db_salt *salts[FMT_MAX_SALTS_PER_CRYPT];
+	int matches[FMT_MAX_SALTS_PER_CRYPT];
+	int count, n, i;
+
+	salts[0] = *salt;
+	for (n = 1; n < FMT_MAX_SALTS_PER_CRYPT && salts[n - 1]->next; n++)
+		salts[n] = salts[n - 1]->next;
+
+#if !OS_TIMER
+	sig_timer_emu_tick();
+#endif
+
+	idle_yield();
+
+	if (event_pending && crk_process_event())
+		return -1;
+
+	if (fp_fix_state)
+		fp_fix_state();
+
+	count = crk_key_index;
+	crk_methods.crypt_all_salts(&count, salts, n, matches);
+	crk_last_key = count;
+
+	for (i = 0; i < n; i++) {
+		unsigned int first = i * crk_params.max_keys_per_crypt;
+		int64 effective_count;
+
+/* Per salt as with crypt_all(), which crk_process_guess() relies on to tell
+ * duplicate guesses for different salts apart */
+		mul32by32(&effective_count, salts[i]->count, count);
+		status_update_crypts(&effective_count, count);
+
+		*salt = salts[i];
+		if (matches[i] &&
+		    crk_match_loop(salts[i], first, first + matches[i]))
+			return 1;
+	}
+
+	return 0;
+}
+
 static int crk_salt_loop(void)
 {
 	int done;
@@ -978,10 +1293,15 @@ static int crk_salt_loop(void)
 		}
 	}
 	do {
-		crk_methods.set_salt(salt->salt);
 		status.resume_salt_md5 = (crk_db->salt_count > 1) ?
 			salt->salt_md5 : NULL;
-		if ((done = crk_password_loop(salt)))
+		if (crk_methods.crypt_all_salts && salt->next)
+			done = crk_salts_loop(&salt);
+		else {
+			crk_methods.set_salt(salt->salt);
+			done = crk_password_loop(salt);
+		}
+		if (done)
 			break;
 	} while ((salt = salt->next));
 	if (!salt || crk_db->salt_count < 2)
@@ -1084,6 +1404,35 @@ int crk_process_key(char *key)
 	return ext_abort;
 }
 
+int crk_key_slots(int *first)
+{
+	int max = crk_params.max_keys_per_crypt;
+
+	if (!crk_db->loaded || !(crk_params.flags & FMT_OMP_SET_KEY))
+		return 0;
+
+	if (crk_key_index == 0)
+		crk_methods.clear_keys();
+
+	if (options.force_maxkeys && options.force_maxkeys < max)
+		max = options.force_maxkeys;
+
+	*first = crk_key_index;
+	return max - crk_key_index;
+}
+
+int crk_add_keys(int count)
+{
+	crk_key_index += count;
+
+	if (crk_key_index >= crk_params.max_keys_per_crypt ||
+	    (options.force_maxkeys &&
+	     crk_key_index >= options.force_maxkeys))
+		return crk_salt_loop();
+
+	return 0;
+}
+
 /* This function is used by single.c only */
 int crk_process_salt(struct db_salt *salt)
 {
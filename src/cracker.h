@@ -33,6 +33,21 @@ extern void crk_init(struct db_main *db, void (*fix_state)(void),
  */
 extern int crk_process_key(char *key);
 
+/*
+ * Lets a cracking mode call the format's set_key() itself, from several
+ * threads at once, instead of passing keys to crk_process_key() one by one.
+ * Returns the number of keys that may be set, starting at index *first, or
+ * zero if keys have to go through crk_process_key() (the format is not
+ * FMT_OMP_SET_KEY, or we're not actually cracking).
+ */
+extern int crk_key_slots(int *first);
+
+/*
+ * Accounts for count keys set after crk_key_slots(), then tries them if the
+ * key buffer is full.  The return value is the same as for crk_process_key().
+ */
+extern int crk_add_keys(int count);
+
 /*
  * Resets the guessed keys buffer and processes all the buffered keys for
  * this salt. The return value is the same as for crk_process_key().
@@ -203,6 +203,33 @@ static char* is_key_right(struct fmt_main *format, int index,
 	if (is_test_fmt_case && index != 0)
 		return "index should be 0 when test_fmt_case";
 
+/*
+ * Have crypt_all_salts() compute this salt second in a block, after some
+ * other one if we have it, then do it all over with crypt_all() below.
+ */
+	if (format->methods.crypt_all_salts && dbsalt && !is_test_fmt_case) {
+		struct db_salt *salts[2];
+		int matches[2];
+		unsigned int first = format->params.max_keys_per_crypt;
+
+		salts[0] = dbsalt->next ? dbsalt->next : dbsalt;
+		salts[1] = dbsalt;
+		count = index + 1;
+		format->methods.crypt_all_salts(&count, salts, 2, matches);
+
+		for (i = matches[1] - 1; i >= 0; i--)
+			if (format->methods.cmp_one(binary, first + i))
+				break;
+		if (i == -1 ||
+		    !format->methods.cmp_exact(ciphertext, first + i))
+			return "crypt_all_salts";
+		for (size = 0; size < PASSWORD_HASH_SIZES; size++)
+		if (format->methods.binary_hash[size] &&
+		    format->methods.get_hash[size](first + i) !=
+		    format->methods.binary_hash[size](binary))
+			return "crypt_all_salts";
+	}
+
 	count = index + 1;
 	match = format->methods.crypt_all(&count, dbsalt);
 
@@ -41,6 +41,11 @@ struct fmt_main;
  */
 #define FMT_SIGNATURES	4
 
+/*
+ * Maximum number of salts passed to the crypt_all_salts() method at once
+ */
+#define FMT_MAX_SALTS_PER_CRYPT	32
+
 /*
  * Some format methods accept pointers to these, yet we can't just include
  * loader.h here because that would be a circular dependency.
@@ -107,9 +112,12 @@ struct db_salt;
 #define FMT_OMP				0x01000000
 /* Poor OpenMP scalability */
 #define FMT_OMP_BAD			0x02000000
+/* set_key() may be called from several threads at once, for distinct indices */
+#define FMT_OMP_SET_KEY			0x04000000
 #else
 #define FMT_OMP				0
 #define FMT_OMP_BAD			0
+#define FMT_OMP_SET_KEY			0
 #endif
 /* We've already warned the user about hashes of this type being present */
 #define FMT_WARNED			0x80000000
@@ -332,6 +340,19 @@ struct fmt_methods {
 
 /* Compares an ASCII ciphertext against a particular crypt_all() output */
 	int (*cmp_exact)(char *source, int index);
+
+/* Optional, may be NULL (and is, unless listed in a format's initializer).
+ * Computes the ciphertexts for the plaintexts set so far against each of the
+ * salt_count (up to FMT_MAX_SALTS_PER_CRYPT) salts at once, as set_salt() and
+ * crypt_all() would for each of them in turn.  For salted fast hashes, this
+ * saves the per-call overhead (thread startup and such) for every salt.
+ * The outputs for salts[n] are at indices n * max_keys_per_crypt and up, to
+ * be used with get_hash[](), cmp_one() and cmp_exact() (but not cmp_all() or
+ * get_key(), which keep using the plain index), and matches[n] is set to what
+ * crypt_all() would have returned for that salt.  The salt last set with
+ * set_salt() remains in effect for crypt_all(). */
+	void (*crypt_all_salts)(int *count, struct db_salt **salts,
+		int salt_count, int *matches);
 };
 
 /*
@@ -31,6 +31,7 @@
 #include "unicode.h"
 #include "mask.h"
 #include "regex.h"
+#include "workq.h"
 #include "memdbg.h"
 
 extern struct fmt_main fmt_LM;
@@ -67,6 +68,9 @@ static unsigned int entry, length;
 static unsigned char numbers[CHARSET_LENGTH];
 static int counts[CHARSET_LENGTH][CHARSET_LENGTH];
 
+/* Whether entries are handed out by workq_next() (--fork only) */
+static int wq;
+
 static unsigned int real_count, real_minc, real_min, real_max, real_size;
 static unsigned char real_chars[CHARSET_SIZE];
 
@@ -121,6 +125,9 @@ static void fix_state(void)
 	rec_entry = entry;
 	rec_length = length;
 	memcpy(rec_numbers, numbers, length);
+
+	if (wq)
+		workq_fix_state();
 }
 
 void inc_hybrid_fix_state(void)
@@ -467,6 +474,8 @@ void do_incremental_crack(struct db_main *db, char *mode)
 	int last_length, last_count;
 	int pos;
 	int our_fmt_len = db->format->params.plaintext_length;
+	uint64_t wq_entry = 0;
+	int wq_claimed = 0, wq_resumed = 0;
 
 	if (!mode) {
 		if (db->format == &fmt_LM) {
@@ -734,6 +743,18 @@ void do_incremental_crack(struct db_main *db, char *mode)
 	rec_restore_mode(restore_state);
 	rec_init(db, save_state);
 
+/*
+ * With dynamic work distribution, each entry is a chunk.  Our first one may
+ * be below where our crash recovery file was at.
+ */
+	wq = workq_chunks && !f_new && !(options.flags & FLG_STACKED);
+	if (wq) {
+		wq_entry = workq_next(&wq_resumed);
+		wq_claimed = 1;
+		if (!wq_resumed)
+			rec_entry = wq_entry;
+	}
+
 	ptr = header->order;
 	entry = 0;
 	while (entry < rec_entry &&
@@ -789,7 +810,15 @@ void do_incremental_crack(struct db_main *db, char *mode)
 		    count >= CHARSET_SIZE)
 			inc_format_error(charset);
 
-		if (entry != rec_entry)
+		if (wq) {
+			while (!wq_claimed || wq_entry < entry) {
+				wq_entry = workq_next(&wq_resumed);
+				wq_claimed = 1;
+			}
+			skip = (wq_entry != entry);
+		}
+
+		if (entry != rec_entry || (wq && !wq_resumed))
 			memset(numbers, 0, sizeof(numbers));
 
 		if (count >= real_count || (fixed && !count))
@@ -89,6 +89,7 @@ static int john_omp_threads_new;
 #include "logger.h"
 #include "status.h"
 #include "recovery.h"
+#include "workq.h"
 #include "options.h"
 #include "config.h"
 #include "bench.h"
@@ -1186,10 +1187,14 @@ static void john_load(void)
 
 		ldr_init_database(&database, &options.loader);
 
-		if ((current = options.passwd->head))
-		do {
-			ldr_load_pw_file(&database, current->data);
-		} while ((current = current->next));
+		if (ldr_load_cache(&database)) {
+			if ((current = options.passwd->head))
+			do {
+				ldr_load_pw_file(&database, current->data);
+			} while ((current = current->next));
+
+			ldr_save_cache(&database);
+		}
 
 		/* Process configuration options that depend on db/format */
 		john_load_conf_db();
@@ -1295,7 +1300,13 @@ static void john_load(void)
 		options.loader.flags |= DB_CRACKED;
 		ldr_init_database(&loop_db, &options.loader);
 
+/*
+ * Keep the plaintexts as we go, so that wordlist mode can use them instead of
+ * reading and parsing the pot file all over again.
+ */
+		loop_db.options->flags |= DB_LOOPBACK;
 		ldr_show_pot_file(&loop_db, loop_pot);
+		loop_db.options->flags &= ~DB_LOOPBACK;
 /*
  * Load optional extra (read-only) pot files. If an entry is a directory,
  * we read all files in it. We currently do NOT recurse.
@@ -1320,6 +1331,9 @@ static void john_load(void)
 				        loop_db.plaintexts->count);
 		}
 		database.plaintexts = loop_db.plaintexts;
+		database.loopback = loop_db.loopback;
+		if (!database.loopback)
+			list_init(&database.loopback);
 		options.loader.flags &= ~DB_CRACKED;
 		fmt_list = save_list;
 		db_main_free(&loop_db);
@@ -1362,6 +1376,7 @@ static void john_load(void)
 			/*
 			 * flush before forking, to avoid multiple log entries
 			 */
+			workq_init();
 			log_flush();
 			john_fork();
 		}
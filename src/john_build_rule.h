@@ -0,0 +1 @@
+#define JOHN_BLD "linux-gnu 64-bit AVX512F-ac"
@@ -14,10 +14,17 @@
 // needs to be above sys/stat.h for mingw, if -std=c99 used.
 #include "jumbo.h"
 #include <sys/stat.h>
+#define NEED_OS_FORK
 #include "os.h"
 #if (!AC_BUILT || HAVE_UNISTD_H) && !_MSC_VER
 #include <unistd.h>
 #endif
+#if OS_FORK || defined(HAVE_MMAP)
+#include <sys/mman.h>
+#endif
+#if OS_FORK
+#include <sys/wait.h>
+#endif
 #ifdef _MSC_VER
 #define S_ISDIR(a) ((a) & _S_IFDIR)
 #endif
@@ -46,6 +53,7 @@
 #include "base64_convert.h"
 #include "md5.h"
 #include "single.h"
+#include "pot_index.h"
 #include "memdbg.h"
 
 #ifdef HAVE_CRYPT
@@ -73,6 +81,21 @@ static int ldr_fmt_salt_size;
  */
 #define RF_ALLOW_MISSING		1
 #define RF_ALLOW_DIR			2
+/* Validate the rest of the file in parallel once the format is known */
+#define RF_PARALLEL			4
+
+/*
+ * If non-zero, ldr_split_line() uses this instead of calling valid() for the
+ * format already chosen, as it's what valid() was found to return by
+ * ldr_pv_start().
+ */
+static int ldr_valid_hint;
+
+/*
+ * Counts of lines ldr_split_line() found invalid for the format chosen and
+ * of warnings about other formats it printed, for ldr_pv_child().
+ */
+static unsigned int ldr_invalid_count, ldr_warned_count;
 
 /*
  * Fast "Strlen" for fields[f]
@@ -169,6 +192,214 @@ int ldr_isa_pot_source(const char *ciphertext) {
 	return (strstr(ciphertext, "$SOURCE_HASH$") != NULL);
 }
 
+static int ldr_split_line(char **login, char **ciphertext,
+	char **gecos, char **home, char **uid,
+	char *source, struct fmt_main **format,
+	struct db_options *db_opts, char *line);
+
+#if OS_FORK
+/*
+ * Parallel validation of hash files.  Once the format is known, the rest of
+ * the file is split into line-aligned chunks and child processes (which
+ * can't mess up our state) run ldr_split_line() on each line, recording one
+ * of these verdicts, in order.  We then go through the file as usual, but
+ * only process the lines that need it, without calling valid() again.
+ *
+ * Separate processes rather than threads are used since none of the format
+ * methods are meant to be thread-safe.
+ */
+#define LDR_PV_SKIP			0x00	/* not to be loaded */
+/* 0x01 to 0xfd: valid, with that many hashes on the line */
+#define LDR_PV_INVALID			0xfe	/* not of the chosen format */
+#define LDR_PV_SERIAL			0xff	/* process the line as usual */
+
+static struct {
+	unsigned char *verdicts;	/* shared with the children */
+	size_t size;
+	uint64_t *counts;		/* lines per chunk, likewise */
+	int64_t *offsets;		/* of each chunk's verdicts */
+	int chunks, chunk;
+	uint64_t line;			/* within the current chunk */
+	int invalid_seen;
+} ldr_pv;
+
+static void ldr_pv_child(struct db_main *db, char *name, int64_t start,
+	int64_t end, unsigned char *verdicts, uint64_t *count)
+{
+	char line_buf[LINE_BUFFER_SIZE], *line, *ex_size_line;
+	char *login, *ciphertext, *gecos, *home, *uid;
+	struct fmt_main *format = db->format;
+	FILE *file;
+	uint64_t n = 0;
+
+	john_main_process = 0;
+
+	if (!(file = fopen(path_expand(name), "r")) ||
+	    jtr_fseek64(file, start, SEEK_SET))
+		_exit(1);
+
+	while (jtr_ftell64(file) < end &&
+	    (ex_size_line = fgetll(line_buf, sizeof(line_buf), file))) {
+		unsigned int invalid = ldr_invalid_count;
+		unsigned int warned = ldr_warned_count;
+		int count;
+
+		line = skip_bom(ex_size_line);
+		count = ldr_split_line(&login, &ciphertext, &gecos, &home,
+		    &uid, NULL, &format, db->options, line);
+		if (ldr_warned_count != warned || count >= LDR_PV_INVALID)
+			verdicts[n++] = LDR_PV_SERIAL;
+		else if (count > 0)
+			verdicts[n++] = count;
+		else if (ldr_invalid_count != invalid)
+			verdicts[n++] = LDR_PV_INVALID;
+		else
+			verdicts[n++] = LDR_PV_SKIP;
+
+		if (ex_size_line != line_buf)
+			MEM_FREE(ex_size_line);
+	}
+
+	if (ferror(file))
+		_exit(1);
+
+	*count = n;
+	_exit(0);
+}
+
+static void ldr_pv_done(void)
+{
+	if (!ldr_pv.verdicts)
+		return;
+
+	munmap(ldr_pv.verdicts, ldr_pv.size);
+	MEM_FREE(ldr_pv.offsets);
+	memset(&ldr_pv, 0, sizeof(ldr_pv));
+}
+
+/*
+ * Validates the rest of the file, from the current position of our stream.
+ */
+static void ldr_pv_start(struct db_main *db, char *name, FILE *file)
+{
+	struct stat file_stat;
+	int64_t start, size, *bounds;
+	FILE *aux;
+	pid_t *pids;
+	int i, n, failed;
+
+	n = cfg_get_int(SECTION_OPTIONS, NULL, "LoaderProcesses");
+	if (n <= 1 || db->options->showtypes ||
+	    (db->format->params.flags & FMT_DYNAMIC))
+		return;
+#ifdef HAVE_FUZZ
+	if (options.flags & FLG_FUZZ_CHK)
+		return;
+#endif
+
+	start = jtr_ftell64(file);
+	if (fstat(fileno(file), &file_stat) || !S_ISREG(file_stat.st_mode) ||
+	    (size = file_stat.st_size - start) < LDR_PARALLEL_MIN_SIZE)
+		return;
+
+/*
+ * There can't be more lines than bytes, so each chunk gets as many bytes
+ * for its verdicts as it has of the file.
+ */
+	ldr_pv.size = n * sizeof(uint64_t) + size;
+	ldr_pv.counts = mmap(NULL, ldr_pv.size, PROT_READ | PROT_WRITE,
+#ifdef MAP_ANON
+	    MAP_SHARED | MAP_ANON,
+#else
+	    MAP_SHARED | MAP_ANONYMOUS,
+#endif
+	    -1, 0);
+	if (ldr_pv.counts == MAP_FAILED) {
+		memset(&ldr_pv, 0, sizeof(ldr_pv));
+		return;
+	}
+	ldr_pv.verdicts = (unsigned char *)ldr_pv.counts;
+	ldr_pv.offsets = mem_alloc(n * sizeof(*ldr_pv.offsets));
+	ldr_pv.chunks = n;
+
+	bounds = mem_alloc((n + 1) * sizeof(*bounds));
+	pids = mem_alloc(n * sizeof(*pids));
+	bounds[0] = start;
+	bounds[n] = start + size;
+	if (!(aux = fopen(path_expand(name), "r")))
+		n = 0;
+	for (i = 1; i < n; i++) {
+		int c;
+
+		bounds[i] = start + size / n * i;
+		if (bounds[i] <= bounds[i - 1]) {
+			bounds[i] = bounds[i - 1];
+			continue;
+		}
+		if (jtr_fseek64(aux, bounds[i] - 1, SEEK_SET))
+			break;
+		while ((c = getc(aux)) != EOF && c != '\n')
+			;
+		bounds[i] = jtr_ftell64(aux);
+	}
+	if (aux)
+		fclose(aux);
+	failed = i < n;
+
+	fflush(stdout);
+	fflush(stderr);
+	for (i = 0; i < n && !failed; i++) {
+		ldr_pv.offsets[i] = n * sizeof(uint64_t) + bounds[i] - start;
+		ldr_pv.counts[i] = 0;
+		if ((pids[i] = fork()) == -1)
+			failed = 1;
+		else if (!pids[i])
+			ldr_pv_child(db, name, bounds[i], bounds[i + 1],
+			    ldr_pv.verdicts + ldr_pv.offsets[i],
+			    &ldr_pv.counts[i]);
+	}
+	n = i;
+
+	for (i = 0; i < n; i++) {
+		int status;
+
+		if (pids[i] == -1)
+			continue;
+		while (waitpid(pids[i], &status, 0) == -1)
+			if (errno != EINTR)
+				break;
+		if (!WIFEXITED(status) || WEXITSTATUS(status))
+			failed = 1;
+	}
+
+	MEM_FREE(pids);
+	MEM_FREE(bounds);
+
+/* If anything went wrong, we simply process the lines as usual */
+	if (failed)
+		ldr_pv_done();
+}
+
+/*
+ * Returns the verdict for the next line, or -1 if we don't have one.
+ */
+static int ldr_pv_next(void)
+{
+	while (ldr_pv.chunk < ldr_pv.chunks &&
+	    ldr_pv.line >= ldr_pv.counts[ldr_pv.chunk]) {
+		ldr_pv.chunk++;
+		ldr_pv.line = 0;
+	}
+
+	if (ldr_pv.chunk >= ldr_pv.chunks) {
+		ldr_pv_done();
+		return -1;
+	}
+
+	return ldr_pv.verdicts[ldr_pv.offsets[ldr_pv.chunk] + ldr_pv.line++];
+}
+#endif
+
 static void read_file(struct db_main *db, char *name, int flags,
 	void (*process_line)(struct db_main *db, char *line))
 {
@@ -176,6 +407,9 @@ static void read_file(struct db_main *db, char *name, int flags,
 	FILE *file;
 	char line_buf[LINE_BUFFER_SIZE], *line, *ex_size_line;
 	int warn_enc;
+#if OS_FORK
+	int tried_parallel = 0;
+#endif
 
 	warn_enc = john_main_process && (options.target_enc != ASCII) &&
 		cfg_get_bool(SECTION_OPTIONS, NULL, "WarnEncoding", 0);
@@ -223,11 +457,37 @@ static void read_file(struct db_main *db, char *name, int flags,
 				        "%s\n", name);
 			}
 		}
+#if OS_FORK
+		if (ldr_pv.verdicts) {
+			int verdict = ldr_pv_next();
+
+/*
+ * Lines that aren't of the chosen format only matter for the first one, as
+ * long as no other format is seen (which the children leave to us).
+ */
+			if (verdict == LDR_PV_SKIP ||
+			    (verdict == LDR_PV_INVALID && ldr_pv.invalid_seen++))
+				goto next;
+			if (verdict > LDR_PV_SKIP && verdict < LDR_PV_INVALID)
+				ldr_valid_hint = verdict;
+		}
+#endif
 		process_line(db, line);
+#if OS_FORK
+		ldr_valid_hint = 0;
+		if ((flags & RF_PARALLEL) && !tried_parallel && db->format) {
+			tried_parallel = 1;
+			ldr_pv_start(db, name, file);
+		}
+next:
+#endif
 		if (ex_size_line != line_buf)
 			MEM_FREE(ex_size_line);
 		check_abort(0);
 	}
+#if OS_FORK
+	ldr_pv_done();
+#endif
 	if (name == options.activepot)
 		crk_pot_pos = jtr_ftell64(file);
 
@@ -279,6 +539,7 @@ void ldr_init_database(struct db_main *db, struct db_options *db_options)
 	}
 
 	list_init(&db->plaintexts);
+	db->loopback = NULL;
 
 	db->salt_count = db->password_count = db->guess_count = 0;
 
@@ -724,7 +985,8 @@ find_format:
 		else
 			prepared = (*format)->methods.prepare(fields, *format);
 		if (prepared)
-			valid = (*format)->methods.valid(prepared, *format);
+			valid = ldr_valid_hint ? ldr_valid_hint :
+				(*format)->methods.valid(prepared, *format);
 		else
 			valid = 0;
 
@@ -744,6 +1006,7 @@ find_format:
 			return valid;
 #endif
 
+		ldr_invalid_count++;
 		ldr_set_encoding(*format);
 
 		alt = fmt_list;
@@ -774,6 +1037,7 @@ find_format:
 			prepared = alt->methods.prepare(fields, alt);
 			if (alt->methods.valid(prepared, alt)) {
 				alt->params.flags |= FMT_WARNED;
+				ldr_warned_count++;
 				if (john_main_process)
 				fprintf(stderr,
 				    "Warning: only loading hashes of type "
@@ -1048,9 +1312,11 @@ static void ldr_load_pw_line(struct db_main *db, char *line)
 
 			current_salt->index = fmt_dummy_hash;
 			current_salt->bitmap = NULL;
+			current_salt->filter = NULL;
 			current_salt->list = NULL;
 			current_salt->hash = &current_salt->list;
 			current_salt->hash_size = -1;
+			current_salt->packed_start = NULL;
 
 			current_salt->count = 0;
 
@@ -1169,7 +1435,463 @@ void ldr_load_pw_file(struct db_main *db, char *name)
 		init = 1;
 	}
 
-	read_file(db, name, RF_ALLOW_DIR, ldr_load_pw_line);
+	read_file(db, name, RF_ALLOW_DIR | RF_PARALLEL, ldr_load_pw_line);
+}
+
+/*
+ * The loader cache file holds what ldr_load_pw_file() has built from the hash
+ * files (before the pot file is applied), keyed on those files' size and
+ * modification time and on the options affecting what gets loaded.  It's in
+ * the native byte order and structure layout, so it's only meant to be read
+ * by the same build.  After the header, the key and the format label come
+ * salt records in salt_hash[] order, each of them followed by its passwords,
+ * all padded to the alignment given in the header.
+ */
+#define LDR_CACHE_MAGIC			"JtRldc1\n"
+
+struct ldr_cache_header {
+	char magic[8];
+	uint64_t size;			/* of the entire file */
+	uint32_t ptr_size, align;
+	uint32_t key_size, label_size;	/* including the NULs */
+	uint32_t binary_size, salt_size;
+	uint32_t salt_count, password_count;
+	uint32_t flags;			/* DB_SPLIT and DB_NODUP */
+};
+
+struct ldr_cache_salt {
+	uint32_t hash, count;
+	uint32_t cost[FMT_TUNABLE_COSTS];
+};
+
+static char *ldr_cache_key;
+static size_t ldr_cache_key_size;
+
+static void ldr_cache_key_add(const char *name, const char *value)
+{
+	size_t size = strlen(name) + 1 + strlen(value) + 1;
+
+	ldr_cache_key = mem_realloc(ldr_cache_key,
+	    ldr_cache_key_size + size + 1);
+	sprintf(ldr_cache_key + ldr_cache_key_size, "%s=%s\n", name, value);
+	ldr_cache_key_size += size;
+}
+
+static void ldr_cache_key_add_num(const char *name, long long value)
+{
+	char buf[24];
+
+	sprintf(buf, "%lld", value);
+	ldr_cache_key_add(name, buf);
+}
+
+static void ldr_cache_key_add_list(const char *name, struct list_main *list)
+{
+	struct list_entry *current;
+
+	if (list && (current = list->head))
+	do {
+		ldr_cache_key_add(name, current->data);
+	} while ((current = current->next));
+}
+
+/*
+ * Builds the key for the hash files and options we've been given, or returns
+ * non-zero if they can't be cached.
+ */
+static int ldr_cache_init_key(struct db_main *db)
+{
+	struct list_entry *current;
+	struct stat file_stat;
+
+	if (db->options->flags & DB_WORDS)
+		return 1;
+
+	ldr_cache_key_size = 0;
+	ldr_cache_key_add("version", JOHN_VERSION);
+	ldr_cache_key_add("format", options.format ? options.format : "");
+	ldr_cache_key_add_num("flags", db->options->flags);
+	ldr_cache_key_add_list("user", db->options->users);
+	ldr_cache_key_add_list("group", db->options->groups);
+	ldr_cache_key_add_list("shell", db->options->shells);
+	ldr_cache_key_add_num("field_sep", db->options->field_sep_char);
+	ldr_cache_key_add_num("show_uid", options.show_uid_in_cracks);
+	ldr_cache_key_add_num("reject_printable",
+	    !!(options.flags & FLG_REJECT_PRINTABLE));
+	ldr_cache_key_add_num("regen_lost_salts", options.regen_lost_salts);
+	ldr_cache_key_add_num("bare_always_valid",
+	    options.dynamic_bare_hashes_always_valid);
+	ldr_cache_key_add_num("input_enc", options.input_enc);
+	ldr_cache_key_add_num("target_enc", options.target_enc);
+	ldr_cache_key_add_num("internal_cp", options.internal_cp);
+	ldr_cache_key_add_num("mem_saving", mem_saving_level);
+	ldr_cache_key_add_num("no_dupe_check", cfg_get_bool(SECTION_OPTIONS,
+	    NULL, "NoLoaderDupeCheck", 0));
+
+	if ((current = options.passwd->head))
+	do {
+		if (stat(path_expand(current->data), &file_stat) ||
+		    !S_ISREG(file_stat.st_mode))
+			return 1;
+		ldr_cache_key_add("file", path_expand(current->data));
+		ldr_cache_key_add_num("size", file_stat.st_size);
+		ldr_cache_key_add_num("mtime", file_stat.st_mtime);
+		ldr_cache_key_add_num("inode", file_stat.st_ino);
+	} while ((current = current->next));
+
+	ldr_cache_key[ldr_cache_key_size++] = 0;
+
+	return 0;
+}
+
+static char *ldr_cache_name(void)
+{
+	return path_expand(path_session(options.session ?
+	    options.session : RECOVERY_NAME, LOADER_CACHE_SUFFIX));
+}
+
+static size_t ldr_cache_align(size_t size, size_t align)
+{
+	return (size + align - 1) & ~(align - 1);
+}
+
+static size_t ldr_cache_get_align(struct fmt_main *format)
+{
+	size_t align = 8;
+
+	while (align < format->params.binary_align ||
+	    align < format->params.salt_align)
+		align <<= 1;
+
+	return align;
+}
+
+/*
+ * Goes through the records, checking that they're all within the file, and
+ * adds them to the database if build is set.  Returns non-zero if the file
+ * turns out to be inconsistent.
+ */
+static int ldr_cache_walk(struct db_main *db, char *map, size_t size,
+	size_t pos, int build)
+{
+	struct ldr_cache_header *header = (struct ldr_cache_header *)map;
+	struct fmt_main *format = db->format;
+	size_t align = header->align, pw_size;
+	struct db_salt *current_salt = NULL, *last_salt = NULL;
+	struct db_password *current_pw, *last_pw;
+	struct ldr_cache_salt *record;
+	uint32_t salt_count, count, total = 0, hash, last_hash = 0;
+	int pw_hash, i;
+	char *field;
+
+	pw_size = db->pw_size;
+	if (!(db->options->flags & DB_LOGIN) &&
+	    format->methods.source != fmt_default_source)
+		pw_size -= sizeof(char *);
+
+#define FIELD(length) \
+	(pos + (length) > size ? NULL : (field = map + pos, \
+	    pos = ldr_cache_align(pos + (length), align), field))
+#define STRING \
+	(pos >= size || !memchr(map + pos, 0, size - pos) ? NULL : \
+	    FIELD(strlen(map + pos) + 1))
+
+	for (salt_count = 0; salt_count < header->salt_count; salt_count++) {
+		void *salt;
+
+		if (!(salt = FIELD(header->salt_size)) ||
+		    !(record = (struct ldr_cache_salt *)FIELD(sizeof(*record))))
+			return 1;
+		if ((hash = record->hash) >= SALT_HASH_SIZE || !record->count)
+			return 1;
+		if (salt_count && hash < last_hash)
+			return 1;
+
+		if (build) {
+			current_salt = mem_alloc_tiny(db->salt_size,
+			    MEM_ALIGN_WORD);
+			current_salt->next = NULL;
+			if (salt_count && hash == last_hash)
+				last_salt->next = current_salt;
+			else
+				db->salt_hash[hash] = current_salt;
+			last_salt = current_salt;
+			last_hash = hash;
+
+			current_salt->salt = salt;
+			for (i = 0; i < FMT_TUNABLE_COSTS; i++)
+				current_salt->cost[i] = record->cost[i];
+
+			current_salt->index = fmt_dummy_hash;
+			current_salt->bitmap = NULL;
+			current_salt->filter = NULL;
+			current_salt->list = NULL;
+			current_salt->hash = &current_salt->list;
+			current_salt->hash_size = -1;
+			current_salt->packed_start = NULL;
+			current_salt->count = record->count;
+		}
+		last_hash = hash;
+		total += record->count;
+
+		last_pw = NULL;
+		for (count = 0; count < record->count; count++) {
+			char *binary, *source = NULL, *login = NULL;
+			char *uid = NULL;
+
+			if (!(binary = FIELD(header->binary_size)))
+				return 1;
+			if (format->methods.source == fmt_default_source &&
+			    !(source = STRING))
+				return 1;
+			if (db->options->flags & DB_LOGIN) {
+				if (!(login = STRING))
+					return 1;
+				if (options.show_uid_in_cracks &&
+				    !(uid = STRING))
+					return 1;
+			}
+
+			if (!build)
+				continue;
+
+			current_pw = mem_alloc_tiny(pw_size, MEM_ALIGN_WORD);
+			current_pw->next = NULL;
+			if (last_pw)
+				last_pw->next = current_pw;
+			else
+				current_salt->list = current_pw;
+			last_pw = current_pw;
+
+			pw_hash = db->password_hash_func(binary);
+			current_pw->next_hash = db->password_hash[pw_hash];
+			db->password_hash[pw_hash] = current_pw;
+
+			if ((db->options->flags & DB_LOGIN) &&
+			    format->methods.source != fmt_default_source &&
+			    sizeof(current_pw->source) >= format->params.binary_size)
+				current_pw->binary = memcpy(&current_pw->source,
+					binary, format->params.binary_size);
+			else
+				current_pw->binary = binary;
+
+			if (source)
+				current_pw->source = source;
+			if (login) {
+				current_pw->login = login;
+				if (uid)
+					current_pw->uid = uid;
+			}
+		}
+	}
+
+#undef FIELD
+#undef STRING
+
+	if (build) {
+		db->salt_count = header->salt_count;
+		db->password_count = header->password_count;
+		db->options->flags |= header->flags;
+	}
+
+	return pos != size || total != header->password_count;
+}
+
+int ldr_load_cache(struct db_main *db)
+{
+	struct ldr_cache_header *header;
+	struct fmt_main *format;
+	struct stat file_stat;
+	size_t size, pos;
+	char *map, *label;
+	FILE *file;
+
+	if (!cfg_get_bool(SECTION_OPTIONS, NULL, "LoaderCache", 0) ||
+	    !(options.flags & FLG_CRACKING_CHK) || ldr_cache_init_key(db))
+		return 1;
+
+	if (!(file = fopen(ldr_cache_name(), "rb")))
+		return 1;
+	if (fstat(fileno(file), &file_stat) ||
+	    file_stat.st_size < (off_t)sizeof(struct ldr_cache_header) ||
+	    file_stat.st_size != (size_t)file_stat.st_size) {
+		fclose(file);
+		return 1;
+	}
+	size = file_stat.st_size;
+
+#ifdef HAVE_MMAP
+/*
+ * Binaries, salts and strings are used right from the mapping, and it's
+ * private in case anything writes to them.
+ */
+	map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+	    fileno(file), 0);
+	if (map == MAP_FAILED) {
+		fclose(file);
+		return 1;
+	}
+#else
+	map = mem_alloc(size);
+	if (fread(map, size, 1, file) != 1) {
+		MEM_FREE(map);
+		fclose(file);
+		return 1;
+	}
+#endif
+	fclose(file);
+
+	header = (struct ldr_cache_header *)map;
+	pos = sizeof(*header);
+	label = map + pos + header->key_size;
+	if (memcmp(header->magic, LDR_CACHE_MAGIC, sizeof(header->magic)) ||
+	    header->size != size || header->ptr_size != sizeof(void *) ||
+	    header->key_size != ldr_cache_key_size ||
+	    pos + header->key_size + header->label_size > size ||
+	    memcmp(map + pos, ldr_cache_key, ldr_cache_key_size) ||
+	    !header->label_size || label[header->label_size - 1])
+		goto out_unmap;
+
+	if ((format = fmt_list))
+	do {
+		if (!strcmp(format->params.label, label))
+			break;
+	} while ((format = format->next));
+
+	if (!format || header->binary_size != format->params.binary_size ||
+	    header->salt_size != format->params.salt_size ||
+	    header->align != ldr_cache_get_align(format) ||
+	    (format->params.flags & (FMT_DYNAMIC | FMT_DYNA_SALT)))
+		goto out_unmap;
+
+	pos = ldr_cache_align(pos + header->key_size + header->label_size,
+	    header->align);
+	db->format = format;
+	if (ldr_cache_walk(db, map, size, pos, 0)) {
+		db->format = NULL;
+		goto out_unmap;
+	}
+
+	ldr_set_encoding(format);
+#ifdef HAVE_OPENCL
+	if (!(options.gpu_devices->count && options.fork &&
+	    strstr(format->params.label, "-opencl")))
+#endif
+	fmt_init(format);
+	dyna_salt_init(format);
+	ldr_init_password_hash(db);
+
+	ldr_cache_walk(db, map, size, pos, 1);
+
+	return 0;
+
+out_unmap:
+#ifdef HAVE_MMAP
+	munmap(map, size);
+#else
+	MEM_FREE(map);
+#endif
+	return 1;
+}
+
+static int ldr_cache_write(FILE *file, const void *data, size_t size,
+	size_t *pos, size_t align)
+{
+	static const char zeroes[MEM_ALIGN_PAGE];
+	size_t pad = ldr_cache_align(*pos + size, align) - (*pos + size);
+
+	*pos += size + pad;
+
+	return (size && fwrite(data, size, 1, file) != 1) ||
+	    (pad && fwrite(zeroes, pad, 1, file) != 1);
+}
+
+void ldr_save_cache(struct db_main *db)
+{
+	struct ldr_cache_header header;
+	struct ldr_cache_salt record;
+	struct fmt_main *format = db->format;
+	struct db_salt *salt;
+	struct db_password *pw;
+	char *name, *tmp_name;
+	size_t pos, align;
+	FILE *file;
+	int hash, error, i;
+
+	if (!ldr_cache_key || !john_main_process || !format ||
+	    !db->password_count || ldr_cache_get_align(format) > MEM_ALIGN_PAGE ||
+	    (format->params.flags & (FMT_DYNAMIC | FMT_DYNA_SALT)))
+		return;
+
+	name = ldr_cache_name();
+	tmp_name = mem_alloc(strlen(name) + 5);
+	sprintf(tmp_name, "%s.tmp", name);
+	if (!(file = fopen(tmp_name, "wb"))) {
+		MEM_FREE(tmp_name);
+		return;
+	}
+
+	align = ldr_cache_get_align(format);
+	memset(&header, 0, sizeof(header));
+	header.ptr_size = sizeof(void *);
+	header.align = align;
+	header.key_size = ldr_cache_key_size;
+	header.label_size = strlen(format->params.label) + 1;
+	header.binary_size = format->params.binary_size;
+	header.salt_size = format->params.salt_size;
+	header.salt_count = db->salt_count;
+	header.password_count = db->password_count;
+	header.flags = db->options->flags & (DB_SPLIT | DB_NODUP);
+
+/* The magic and size go in last, once everything else made it */
+	pos = 0;
+	error = ldr_cache_write(file, &header, sizeof(header), &pos, 1) ||
+	    ldr_cache_write(file, ldr_cache_key, ldr_cache_key_size, &pos, 1) ||
+	    ldr_cache_write(file, format->params.label, header.label_size,
+	    &pos, align);
+
+	memset(&record, 0, sizeof(record));
+	for (hash = 0; hash < SALT_HASH_SIZE && !error; hash++)
+	for (salt = db->salt_hash[hash]; salt && !error; salt = salt->next) {
+		record.hash = hash;
+		record.count = salt->count;
+		for (i = 0; i < FMT_TUNABLE_COSTS; i++)
+			record.cost[i] = salt->cost[i];
+		error = ldr_cache_write(file, salt->salt, header.salt_size,
+		    &pos, align) ||
+		    ldr_cache_write(file, &record, sizeof(record), &pos, align);
+
+		for (pw = salt->list; pw && !error; pw = pw->next) {
+			error = ldr_cache_write(file, pw->binary,
+			    header.binary_size, &pos, align);
+			if (format->methods.source == fmt_default_source)
+				error |= ldr_cache_write(file, pw->source,
+				    strlen(pw->source) + 1, &pos, align);
+			if (!(db->options->flags & DB_LOGIN))
+				continue;
+			error |= ldr_cache_write(file, pw->login,
+			    strlen(pw->login) + 1, &pos, align);
+			if (options.show_uid_in_cracks)
+				error |= ldr_cache_write(file, pw->uid,
+				    strlen(pw->uid) + 1, &pos, align);
+		}
+	}
+
+	memcpy(header.magic, LDR_CACHE_MAGIC, sizeof(header.magic));
+	header.size = pos;
+	if (!error)
+		error = fseek(file, 0, SEEK_SET) ||
+		    fwrite(&header, sizeof(header), 1, file) != 1;
+	if (fclose(file) || error || rename(tmp_name, name))
+		unlink(tmp_name);
+
+	MEM_FREE(tmp_name);
+}
+
+void ldr_remove_cache(void)
+{
+	if (cfg_get_bool(SECTION_OPTIONS, NULL, "LoaderCache", 0))
+		unlink(ldr_cache_name());
 }
 
 int ldr_trunc_valid(char *ciphertext, struct fmt_main *format)
@@ -1322,11 +2044,60 @@ void ldr_free_test_db(struct db_main *db)
 	}
 }
 
+/*
+ * Returns the ciphertext as log_guess() would have written it to the pot file,
+ * given what the format's source() method returns.
+ */
+static char *ldr_pot_ciphertext(char *source,
+	char buffer[LINE_BUFFER_SIZE + 1])
+{
+	char *ciphertext = (char *)ldr_pot_source(source, buffer);
+
+#ifndef DYNAMIC_DISABLED
+	if (!strncmp(ciphertext, "$dynamic_", 9))
+		ciphertext = dynamic_FIX_SALT_TO_HEX(ciphertext);
+#endif
+
+	return ciphertext;
+}
+
+/*
+ * Look up each of the loaded hashes in the pot file index and process just
+ * the matching pot lines.
+ */
+static void ldr_load_pot_index(struct db_main *db)
+{
+	char buffer[LINE_BUFFER_SIZE + 1];
+	struct db_salt *salt;
+	struct db_password *pw;
+	int hash;
+
+	for (hash = 0; hash < SALT_HASH_SIZE; hash++)
+	for (salt = db->salt_hash[hash]; salt; salt = salt->next)
+	for (pw = salt->list; pw; pw = pw->next) {
+		if (!pw->binary) /* already marked for removal */
+			continue;
+		pot_index_lookup(db, ldr_pot_ciphertext(
+		    db->format->methods.source(pw->source, pw->binary),
+		    buffer), ldr_load_pot_line);
+	}
+}
+
 void ldr_load_pot_file(struct db_main *db, char *name)
 {
+	int64_t indexed;
+
 	if (db->format && !(db->format->params.flags & FMT_NOT_EXACT)) {
 		ldr_in_pot = 1;
-		read_file(db, name, RF_ALLOW_MISSING, ldr_load_pot_line);
+		if (!options.regen_lost_salts && db->salt_hash &&
+		    !pot_index_open(name, &indexed)) {
+			ldr_load_pot_index(db);
+			pot_index_close();
+			if (name == options.activepot)
+				crk_pot_pos = indexed;
+		} else
+			read_file(db, name, RF_ALLOW_MISSING,
+			    ldr_load_pot_line);
 		ldr_in_pot = 0;
 	}
 }
@@ -1685,11 +2456,85 @@ static void ldr_filter_costs(struct db_main *db)
 	} while ((current = current->next));
 }
 
+/*
+ * Store a copy of this salt's binaries contiguously, sorted by hash table
+ * bucket, and point the entries at their copies.  The lookups then touch one
+ * small array of offsets and the binaries themselves rather than chase a list
+ * of structures scattered all over the memory.
+ */
+static void ldr_init_packed(struct db_main *db, struct db_salt *salt,
+	int (*hash_func)(void *binary), size_t hash_size)
+{
+	struct db_password *current;
+	unsigned int *start, bucket, index;
+	char *binary;
+
+	start = mem_calloc_tiny((hash_size + 1) * sizeof(*start),
+	    sizeof(*start));
+	current = salt->list;
+	do {
+		start[(hash_func(current->binary) >> PASSWORD_HASH_SHR) + 1]++;
+	} while ((current = current->next));
+	for (bucket = 1; bucket <= hash_size; bucket++)
+		start[bucket] += start[bucket - 1];
+
+	binary = mem_alloc_tiny(salt->count * db->packed_size,
+	    db->format->params.binary_align);
+	salt->packed_pw = mem_alloc_tiny(salt->count * sizeof(*salt->packed_pw),
+	    MEM_ALIGN_WORD);
+
+/*
+ * start[bucket] is used as the insertion point for the bucket here, leaving
+ * it pointing to the next bucket's first entry.
+ */
+	current = salt->list;
+	do {
+		bucket = hash_func(current->binary) >> PASSWORD_HASH_SHR;
+		index = start[bucket]++;
+		salt->packed_pw[index] = current;
+		current->binary = memcpy(binary + index * db->packed_size,
+		    current->binary, db->format->params.binary_size);
+		current->next_hash = NULL; /* unused */
+	} while ((current = current->next));
+	memmove(&start[1], start, hash_size * sizeof(*start));
+	start[0] = 0;
+
+	salt->packed_binary = binary;
+	salt->packed_start = start;
+}
+
+/*
+ * Size in bytes of the bitmaps used as a first-level filter: a power of two
+ * no larger than half of the L2 cache, so that the filter stays in there
+ * along with some of everything else.  Zero when not to be used.
+ */
+static size_t ldr_filter_size(void)
+{
+	long cache = 0;
+	size_t size;
+
+	if (mem_saving_level)
+		return 0;
+
+#ifdef _SC_LEVEL2_CACHE_SIZE
+	cache = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+	if (cache <= 0)
+		cache = 256 << 10;
+
+	size = 4096;
+	while (size <= cache / 4)
+		size <<= 1;
+
+	return size;
+}
+
 /*
  * Allocate memory for and initialize the hash table for this salt if needed.
  * Also initialize salt->count (the number of password hashes for this salt).
  */
-static void ldr_init_hash_for_salt(struct db_main *db, struct db_salt *salt)
+static void ldr_init_hash_for_salt(struct db_main *db, struct db_salt *salt,
+	size_t filter_size)
 {
 	struct db_password *current;
 	int (*hash_func)(void *binary);
@@ -1716,8 +2561,19 @@ static void ldr_init_hash_for_salt(struct db_main *db, struct db_salt *salt)
 		memset(salt->bitmap, 0, size);
 	}
 
+/*
+ * The filter is only of use when the bitmap doesn't fit in the cache, and as
+ * long as it would be mostly zeroes.
+ */
+	if (filter_size && bitmap_size / 8 > filter_size &&
+	    salt->count <= filter_size * 8 / 4) {
+		salt->filter = mem_calloc_tiny(filter_size,
+		    sizeof(*salt->filter));
+		salt->filter_mask = filter_size * 8 - 1;
+	}
+
 	hash_size = bitmap_size >> PASSWORD_HASH_SHR;
-	if (hash_size > 1) {
+	if (hash_size > 1 && !db->packed_size) {
 		size_t size = hash_size * sizeof(struct db_password *);
 		salt->hash = mem_alloc_tiny(size, MEM_ALIGN_WORD);
 		memset(salt->hash, 0, size);
@@ -1733,7 +2589,11 @@ static void ldr_init_hash_for_salt(struct db_main *db, struct db_salt *salt)
 		hash = hash_func(current->binary);
 		salt->bitmap[hash / (sizeof(*salt->bitmap) * 8)] |=
 		    1U << (hash % (sizeof(*salt->bitmap) * 8));
-		if (hash_size > 1) {
+		if (salt->filter)
+			salt->filter[(hash & salt->filter_mask) /
+			    (sizeof(*salt->filter) * 8)] |=
+			    1U << (hash % (sizeof(*salt->filter) * 8));
+		if (hash_size > 1 && !db->packed_size) {
 			hash >>= PASSWORD_HASH_SHR;
 			current->next_hash = salt->hash[hash];
 			salt->hash[hash] = current;
@@ -1741,6 +2601,9 @@ static void ldr_init_hash_for_salt(struct db_main *db, struct db_salt *salt)
 			current->next_hash = current->next;
 		salt->count++;
 	} while ((current = current->next));
+
+	if (hash_size > 1 && db->packed_size)
+		ldr_init_packed(db, salt, hash_func, hash_size);
 }
 
 /*
@@ -1751,6 +2614,16 @@ static void ldr_init_hash(struct db_main *db)
 {
 	struct db_salt *current;
 	int threshold, size;
+	size_t filter_size = ldr_filter_size();
+
+	db->packed_size = 0;
+	if (db->format && db->format->params.binary_size &&
+	    cfg_get_bool(SECTION_OPTIONS, NULL, "PackedHashTables", 0)) {
+		size_t align = db->format->params.binary_align;
+
+		db->packed_size = (db->format->params.binary_size + align - 1) /
+		    align * align;
+	}
 
 	threshold = password_hash_thresholds[0];
 	if (db->format && (db->format->params.flags & FMT_BS)) {
@@ -1779,7 +2652,7 @@ static void ldr_init_hash(struct db_main *db)
 			size--;
 
 		current->hash_size = size;
-		ldr_init_hash_for_salt(db, current);
+		ldr_init_hash_for_salt(db, current, filter_size);
 #ifdef DEBUG_HASH
 		if (current->hash_size > 0)
 			printf("salt %08x, binary hash size 0x%x (%d), "
@@ -1933,6 +2806,8 @@ static void ldr_show_pot_line(struct db_main *db, char *line)
 			list_add(db->plaintexts, line);
 			return;
 		}
+		if (db->options->flags & DB_LOOPBACK)
+			ldr_loopback_add(db, line);
 /*
  * Jumbo-specific; split() needed for legacy pot entries so we need to
  * enumerate formats and call valid(). This also takes care of the situation
@@ -1965,8 +2840,95 @@ static void ldr_show_pot_line(struct db_main *db, char *line)
 	}
 }
 
+/*
+ * Open addressing hash table of the entries of the loopback list, so that
+ * adding to it doesn't get slower as it grows.  Kept at most half full.
+ */
+static struct list_entry **ldr_loop_hash;
+static unsigned int ldr_loop_hash_mask;
+
+static unsigned int ldr_loop_hash_func(char *plain)
+{
+	unsigned char *p = (unsigned char *)plain;
+	unsigned int hash = 0x811c9dc5;
+
+	while (*p)
+		hash = (hash ^ *p++) * 0x01000193;
+
+	return hash ^ (hash >> 15);
+}
+
+static void ldr_loop_hash_insert(struct list_entry *entry)
+{
+	unsigned int i = ldr_loop_hash_func(entry->data) & ldr_loop_hash_mask;
+
+	while (ldr_loop_hash[i])
+		i = (i + 1) & ldr_loop_hash_mask;
+	ldr_loop_hash[i] = entry;
+}
+
+void ldr_loopback_add(struct db_main *db, char *plain)
+{
+	struct list_entry *entry;
+	unsigned int i;
+
+	if (!db->loopback)
+		list_init(&db->loopback);
+
+	if ((unsigned int)db->loopback->count >= ldr_loop_hash_mask / 2) {
+		unsigned int size = ldr_loop_hash_mask ?
+			(ldr_loop_hash_mask + 1) * 2 : 0x1000;
+
+		MEM_FREE(ldr_loop_hash);
+		ldr_loop_hash = mem_calloc(size, sizeof(*ldr_loop_hash));
+		ldr_loop_hash_mask = size - 1;
+		for (entry = db->loopback->head; entry; entry = entry->next)
+			ldr_loop_hash_insert(entry);
+	}
+
+	i = ldr_loop_hash_func(plain) & ldr_loop_hash_mask;
+	while ((entry = ldr_loop_hash[i])) {
+		if (!strcmp(entry->data, plain))
+			return;
+		i = (i + 1) & ldr_loop_hash_mask;
+	}
+
+	list_add(db->loopback, plain);
+	ldr_loop_hash[i] = db->loopback->tail;
+}
+
+/*
+ * Adds the pot lines for this ciphertext (as split() returned it) found via
+ * the pot file index to cracked_hash[], unless already there.
+ */
+static void ldr_show_pot_index(struct db_main *db, char *piece, int hash)
+{
+	char buffer[LINE_BUFFER_SIZE + 1];
+	struct db_cracked *current;
+
+	for (current = db->cracked_hash[hash]; current; current = current->next)
+		if (!ldr_pot_source_cmp(current->ciphertext, piece))
+			return;
+
+	ldr_in_pot = 1;
+	pot_index_lookup(db, ldr_pot_ciphertext(piece, buffer),
+	    ldr_show_pot_line);
+	ldr_in_pot = 0;
+}
+
 void ldr_show_pot_file(struct db_main *db, char *name)
 {
+	int64_t indexed;
+
+/*
+ * For --show, we can look up just the hashes we're asked about in the pot
+ * file index as we go, see ldr_show_pw_line().
+ */
+	if ((options.flags & FLG_SHOW_CHK) &&
+	    !(db->options->flags & DB_PLAINTEXTS) &&
+	    name == options.activepot && !pot_index_open(name, &indexed))
+		return;
+
 	ldr_in_pot = 1;
 	read_file(db, name, RF_ALLOW_MISSING, ldr_show_pot_line);
 	ldr_in_pot = 0;
@@ -2071,6 +3033,9 @@ static void ldr_show_pw_line(struct db_main *db, char *line)
 
 		hash = ldr_cracked_hash(piece);
 
+		if (!pass && pot_index_is_open())
+			ldr_show_pot_index(db, piece, hash);
+
 		if ((current = db->cracked_hash[hash]))
 		do {
 			char *pot = current->ciphertext;
@@ -122,6 +122,12 @@ struct db_salt {
  * bits are zero. */
 	unsigned int *bitmap;
 
+/* Smaller bitmap checked before the one above when that one is too large to
+ * stay in the CPU's L2 cache, indexed by the low bits of the same hash.  Its
+ * bits are never reset as hashes get cracked.  NULL if not in use. */
+	unsigned int *filter;
+	unsigned int filter_mask;
+
 /* Pointer to a hash function to get the bit index into the bitmap above for
  * the crypt_all() method output with given index.  The function always returns
  * zero if there's no bitmap for this salt. */
@@ -136,6 +142,14 @@ struct db_salt {
 /* Hash table size code, negative for none */
 	int hash_size;
 
+/* Packed alternative to the hash table above (PackedHashTables in john.conf):
+ * the binaries stored contiguously in hash bucket order, the corresponding
+ * entries (NULL once removed), and the index of each bucket's first entry
+ * (one extra at the end).  packed_start is NULL when not in use. */
+	void *packed_binary;
+	struct db_password **packed_pw;
+	unsigned int *packed_start;
+
 /* Number of passwords with this salt */
 	int count;
 
@@ -181,6 +195,8 @@ struct db_cracked {
 #define DB_CRACKED			0x00000100
 /* Cracked plaintexts list */
 #define DB_PLAINTEXTS			0x00000200
+/* Pot file plaintexts for loopback mode, see ldr_loopback_add() */
+#define DB_LOOPBACK			0x00000400
 
 /*
  * Password database options.
@@ -228,6 +244,10 @@ struct db_main {
  * possibly adjusted by ldr_init_database() given options->flags and such. */
 	size_t pw_size, salt_size;
 
+/* Size of each entry in the salts' packed_binary arrays, 0 if these aren't
+ * used */
+	size_t packed_size;
+
 /* Options */
 	struct db_options *options;
 
@@ -247,6 +267,9 @@ struct db_main {
 /* Cracked plaintexts list */
 	struct list_main *plaintexts;
 
+/* Plaintexts for loopback mode, each once, or NULL if not collected */
+	struct list_main *loopback;
+
 /* Number of salts, passwords and guesses */
 	int salt_count, password_count, guess_count;
 
@@ -286,6 +309,25 @@ extern void ldr_load_pw_line(struct db_main *db, char *line);
  */
 extern void ldr_load_pw_file(struct db_main *db, char *name);
 
+/*
+ * Loads the database from the loader cache file (when LoaderCache is set in
+ * john.conf and we're about to crack) if that was saved from the same hash
+ * files with the same options, in place of ldr_load_pw_file() calls for them.
+ * Returns zero on success, or non-zero if the hash files are to be loaded.
+ */
+extern int ldr_load_cache(struct db_main *db);
+
+/*
+ * Saves what ldr_load_pw_file() has loaded to the loader cache file, if
+ * ldr_load_cache() was called and found none for these hash files.
+ */
+extern void ldr_save_cache(struct db_main *db);
+
+/*
+ * Removes the loader cache file, called once the session is completed.
+ */
+extern void ldr_remove_cache(void);
+
 /*
  * Removes passwords cracked in previous sessions from the database.
  */
@@ -318,6 +360,14 @@ extern void ldr_show_pot_file(struct db_main *db, char *name);
  */
 extern void ldr_show_pw_file(struct db_main *db, char *name);
 
+/*
+ * Appends a plaintext, as it's written to the pot file, to db->loopback
+ * (creating the list if needed) unless it's already there.  Used for pot
+ * lines read with DB_LOOPBACK set, and for passwords cracked later on so
+ * that loopback mode can pick them up as it goes.
+ */
+extern void ldr_loopback_add(struct db_main *db, char *plain);
+
 /* Compare a possibly truncated pot source with a full one */
 extern int ldr_pot_source_cmp(const char *pot_entry, const char *full_source);
 
@@ -40,6 +40,9 @@
 #include <stdarg.h>
 #include <string.h>
 #include <signal.h>
+#if HAVE_PTHREAD
+#include <pthread.h>
+#endif
 
 #include "arch.h"
 #include "misc.h"
@@ -58,6 +61,7 @@
 #endif
 #include "cracker.h"
 #include "signals.h"
+#include "pot_index.h"
 #include "memdbg.h"
 
 static int cfg_beep;
@@ -101,6 +105,13 @@ struct log_file {
 	char *buffer, *ptr;
 	int size;
 	int fd;
+#if HAVE_PTHREAD
+	char *spare;		/* the other buffer, if not being written */
+	char *pending;		/* buffer handed to the writer thread */
+	int pending_count;
+	int error;		/* errno of a failure in the writer thread */
+	const char *error_op;
+#endif
 };
 
 #ifdef _MSC_VER
@@ -113,6 +124,53 @@ static struct log_file pot = {NULL, NULL, NULL, 0, -1};
 
 static int in_logger = 0;
 
+#if HAVE_PTHREAD
+/*
+ * With AsyncLogWrites set in john.conf, a buffer that has filled up is handed
+ * to a writer thread, and we go on with the file's other buffer instead of
+ * waiting for the file lock and write(2) in the middle of cracking.  There's
+ * at most one buffer per file pending, so we only have to wait if the writer
+ * is a whole buffer behind.  Everything else (log_flush() and log_done(),
+ * including on timer, signals and errors) waits for the pending writes and
+ * then proceeds as usual, so the files get exactly the same contents.
+ */
+static struct {
+	int enabled;
+	pid_t pid;		/* of the process the thread runs in, if any */
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	int quit;
+} writer;
+
+static int log_in_writer(void)
+{
+	return writer.pid == getpid() &&
+		pthread_equal(pthread_self(), writer.thread);
+}
+#endif
+
+/*
+ * Reports a failed system call on the file, which is fatal unless it's the
+ * writer thread's, in which case that's left for the main thread to find.
+ */
+static void log_file_failed(struct log_file *f, const char *op)
+{
+#if HAVE_PTHREAD
+	if (log_in_writer()) {
+		f->error = errno;
+		f->error_op = op;
+		return;
+	}
+#endif
+	pexit("%s", op);
+}
+
+static char *log_file_alloc(int size)
+{
+	return mem_alloc(size + LINE_BUFFER_SIZE + PLAINTEXT_BUFFER_SIZE + 64);
+}
+
 static void log_file_init(struct log_file *f, char *name, char *perms, int size)
 {
 	perms_t = strtoul(perms, NULL, 8);
@@ -154,24 +212,22 @@ static void log_file_init(struct log_file *f, char *name, char *perms, int size)
 	 * longer have to check length before a write (.pot or .log file).
 	 * The "64" comes from core.
 	 */
-	f->ptr = f->buffer =
-		mem_alloc(size + LINE_BUFFER_SIZE + PLAINTEXT_BUFFER_SIZE + 64);
+	f->ptr = f->buffer = log_file_alloc(size);
 	f->size = size;
 }
 
-static void log_file_flush(struct log_file *f)
+/*
+ * Writes out count bytes from buffer, with the file locked.  This is what
+ * the writer thread does with a pending buffer, too.
+ */
+static void log_file_write_buffer(struct log_file *f, char *buffer,
+	int count)
 {
-	int count;
 	long int pos_b4 = 0;
 #if FCNTL_LOCKS
 	struct flock lock;
 #endif
 
-	if (f->fd < 0) return;
-
-	count = f->ptr - f->buffer;
-	if (count <= 0) return;
-
 #if OS_FLOCK || FCNTL_LOCKS
 #ifdef LOCK_DEBUG
 	fprintf(stderr, "%s(%u): Locking %s...\n",
@@ -181,13 +237,17 @@ static void log_file_flush(struct log_file *f)
 	memset(&lock, 0, sizeof(lock));
 	lock.l_type = F_WRLCK;
 	while (fcntl(f->fd, F_SETLKW, &lock)) {
-		if (errno != EINTR)
-			pexit("fcntl(F_WRLCK)");
+		if (errno != EINTR) {
+			log_file_failed(f, "fcntl(F_WRLCK)");
+			return;
+		}
 	}
 #else
 	while (flock(f->fd, LOCK_EX)) {
-		if (errno != EINTR)
-			pexit("flock(LOCK_EX)");
+		if (errno != EINTR) {
+			log_file_failed(f, "flock(LOCK_EX)");
+			return;
+		}
 	}
 #endif
 #ifdef LOCK_DEBUG
@@ -206,8 +266,12 @@ static void log_file_flush(struct log_file *f)
 #endif
 	}
 
-	if (write_loop(f->fd, f->buffer, count) < 0) pexit("write");
-	f->ptr = f->buffer;
+	if (write_loop(f->fd, buffer, count) < 0) {
+		log_file_failed(f, "write");
+		return;
+	}
+	if (f == &pot)
+		pot_index_log(pos_b4, buffer, count);
 
 	if (f == &pot && pos_b4 == crk_pot_pos)
 		crk_pot_pos += count;
@@ -221,8 +285,10 @@ static void log_file_flush(struct log_file *f)
 	lock.l_type = F_UNLCK;
 	fcntl(f->fd, F_SETLK, &lock);
 #else
-	if (flock(f->fd, LOCK_UN))
-		pexit("flock(LOCK_UN)");
+	if (flock(f->fd, LOCK_UN)) {
+		log_file_failed(f, "flock(LOCK_UN)");
+		return;
+	}
 #endif
 #endif
 
@@ -250,16 +316,186 @@ static void log_file_flush(struct log_file *f)
 		} else
 #endif
 		if (options.fork)
+#if HAVE_PTHREAD
+			kill(getpid(), SIGUSR2); /* not to the writer thread */
+#else
 			raise(SIGUSR2);
+#endif
+	}
+#endif
+}
+
+#if HAVE_PTHREAD
+static void *log_writer(void *arg)
+{
+	struct log_file *f;
+
+	pthread_mutex_lock(&writer.mutex);
+	while (1) {
+		if (pot.pending)
+			f = &pot;
+		else if (log.pending)
+			f = &log;
+		else if (writer.quit)
+			break;
+		else {
+			pthread_cond_wait(&writer.cond, &writer.mutex);
+			continue;
+		}
+
+		pthread_mutex_unlock(&writer.mutex);
+		log_file_write_buffer(f, f->pending, f->pending_count);
+		pthread_mutex_lock(&writer.mutex);
+
+		f->spare = f->pending;
+		f->pending = NULL;
+		pthread_cond_broadcast(&writer.cond);
+	}
+	pthread_mutex_unlock(&writer.mutex);
+
+	return NULL;
+}
+
+/*
+ * Starts the writer thread in this process unless it's already running.
+ * Returns non-zero if we're to write synchronously instead.
+ */
+static int log_writer_start(void)
+{
+	sigset_t all, old;
+	int error;
+
+	if (writer.pid == getpid())
+		return 0;
+
+/*
+ * If we're a child process forked after the thread was started in the
+ * parent, the parent takes care of any buffers that were pending then.
+ */
+	if (writer.pid) {
+		pot.pending = log.pending = NULL;
+		writer.pid = 0;
+	}
+
+	if (pthread_mutex_init(&writer.mutex, NULL))
+		return writer.enabled = 0, 1;
+	if (pthread_cond_init(&writer.cond, NULL)) {
+		pthread_mutex_destroy(&writer.mutex);
+		return writer.enabled = 0, 1;
+	}
+
+/* Signals are for the main thread to handle */
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &old);
+	writer.quit = 0;
+	error = pthread_create(&writer.thread, NULL, log_writer, NULL);
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+	if (error) {
+		pthread_cond_destroy(&writer.cond);
+		pthread_mutex_destroy(&writer.mutex);
+		return writer.enabled = 0, 1;
+	}
+
+	writer.pid = getpid();
+
+	return 0;
+}
+
+static void log_writer_stop(void)
+{
+	if (writer.pid != getpid())
+		return;
+
+	pthread_mutex_lock(&writer.mutex);
+	writer.quit = 1;
+	pthread_cond_broadcast(&writer.cond);
+	pthread_mutex_unlock(&writer.mutex);
+
+	pthread_join(writer.thread, NULL);
+	pthread_cond_destroy(&writer.cond);
+	pthread_mutex_destroy(&writer.mutex);
+	writer.pid = 0;
+}
+
+/*
+ * Waits for the file's pending buffer, if any, to be written.
+ */
+static void log_file_wait(struct log_file *f)
+{
+	if (writer.pid != getpid())
+		return;
+
+	pthread_mutex_lock(&writer.mutex);
+	while (f->pending)
+		pthread_cond_wait(&writer.cond, &writer.mutex);
+	pthread_mutex_unlock(&writer.mutex);
+
+	if (f->error) {
+		errno = f->error;
+		f->error = 0;
+		pexit("%s", f->error_op);
+	}
+}
+#endif
+
+static void log_file_flush(struct log_file *f)
+{
+	int count;
+
+	if (f->fd < 0) return;
+
+#if HAVE_PTHREAD
+	log_file_wait(f);
+#endif
+
+	count = f->ptr - f->buffer;
+	if (count <= 0) return;
+
+	log_file_write_buffer(f, f->buffer, count);
+	f->ptr = f->buffer;
+}
+
+/*
+ * Like log_file_flush(), but leaves the writing to the writer thread if
+ * there's one.
+ */
+static void log_file_submit(struct log_file *f)
+{
+#if HAVE_PTHREAD
+	int count;
+
+	if (f->fd < 0) return;
+
+	count = f->ptr - f->buffer;
+	if (count <= 0) return;
+
+	if (writer.enabled && !log_writer_start()) {
+		log_file_wait(f);
+
+		if (!f->spare)
+			f->spare = log_file_alloc(f->size);
+
+		pthread_mutex_lock(&writer.mutex);
+		f->pending = f->buffer;
+		f->pending_count = count;
+		pthread_cond_broadcast(&writer.cond);
+		pthread_mutex_unlock(&writer.mutex);
+
+		f->ptr = f->buffer = f->spare;
+		f->spare = NULL;
+		return;
 	}
 #endif
+
+	log_file_flush(f);
 }
 
 static int log_file_write(struct log_file *f)
 {
 	if (f->fd < 0) return 0;
 	if (f->ptr - f->buffer > f->size) {
-		log_file_flush(f);
+		log_file_submit(f);
 		return 1;
 	}
 
@@ -288,6 +524,9 @@ static void log_file_done(struct log_file *f, int do_sync)
 	f->fd = -1;
 
 	MEM_FREE(f->buffer);
+#if HAVE_PTHREAD
+	MEM_FREE(f->spare);
+#endif
 }
 
 static int log_time(void)
@@ -374,8 +613,18 @@ void log_init(char *log_name, char *pot_name, char *session)
 			pot_perms = "0600";
 
 		log_file_init(&pot, pot_name, pot_perms, POT_BUFFER_SIZE);
+		pot_index_log_init(pot_name);
 
 		cfg_beep = cfg_get_bool(SECTION_OPTIONS, NULL, "Beep", 0);
+
+#if HAVE_PTHREAD
+		writer.enabled = cfg_get_bool(SECTION_OPTIONS, NULL,
+		                              "AsyncLogWrites", 0);
+#ifdef HAVE_MPI
+		if (mpi_p > 1) /* the writer would need MPI_THREAD_MULTIPLE */
+			writer.enabled = 0;
+#endif
+#endif
 	}
 
 	cfg_log_passwords = cfg_get_bool(SECTION_OPTIONS, NULL,
@@ -511,10 +760,10 @@ void log_guess(char *login, char *uid, char *ciphertext, char *rep_plain,
 
 /* Try to keep the two files in sync */
 	if (log_file_write(&pot))
-		log_file_flush(&log);
+		log_file_submit(&log);
 	else
 	if (log_file_write(&log))
-		log_file_flush(&pot);
+		log_file_submit(&pot);
 
 	in_logger = 0;
 
@@ -590,7 +839,7 @@ void log_event(const char *format, ...)
 			log.ptr -= count1;
 
 		if (log_file_write(&log))
-			log_file_flush(&pot);
+			log_file_submit(&pot);
 	}
 
 	in_logger = 0;
@@ -626,6 +875,21 @@ void log_done(void)
 
 	log_file_done(&log, !options.fork);
 	log_file_done(&pot, 1);
+#if HAVE_PTHREAD
+	log_writer_stop();
+#endif
 
 	in_logger = 0;
 }
+
+void log_wait(void)
+{
+#if HAVE_PTHREAD
+	in_logger = 1;
+
+	log_file_wait(&pot);
+	log_file_wait(&log);
+
+	in_logger = 0;
+#endif
+}
@@ -53,6 +53,12 @@ extern void log_discard(void);
  */
 extern void log_flush(void);
 
+/*
+ * Waits for any writes to john.pot and the log file that are in progress in
+ * the background (see AsyncLogWrites in john.conf) to complete.
+ */
+extern void log_wait(void);
+
 /*
  * Closes john.pot and the log file.
  */
@@ -14,6 +14,9 @@
 #include <string.h>
 #include <ctype.h>
 #include <assert.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "arch.h"
 #include "misc.h" /* for error() */
@@ -30,6 +33,7 @@
 #include "mask.h"
 #include "unicode.h"
 #include "encoding_data.h"
+#include "workq.h"
 #include "memdbg.h"
 #include "mask_ext.h"
 
@@ -65,6 +69,14 @@ static unsigned long long cand, rec_cand;
 unsigned long long mask_tot_cand;
 unsigned long long mask_parent_keys;
 
+/*
+ * Dynamic work distribution for --fork (see workq.h).  The keyspace of each
+ * length we iterate over is split in wq_parts chunks.
+ */
+static unsigned int wq_parts;
+static int wq_need = 1, wq_resumed;
+static uint64_t wq_chunk;
+
 #define BUILT_IN_CHARSET "ludsaLUDSAbhBH123456789"
 
 #define store_op(k, i) \
@@ -1536,6 +1548,114 @@ static MAYBE_INLINE char* mask_cp_to_utf8(char *in)
 		start ? start + ranges(ps).iter:			\
 		ranges(ps).chars[ranges(ps).iter];
 
+/* Sets the placeholders to the offset'th candidate */
+static void seek_offset(mask_cpu_context *cpu_mask_ctx,
+                        unsigned long long offset)
+{
+	unsigned long long ctr;
+	int ps;
+
+	ctr = 1;
+	ps = cpu_mask_ctx->ps1;
+	while(ps != MAX_NUM_MASK_PLHDR) {
+		cpu_mask_ctx->ranges[ps].iter = (offset / ctr) %
+			cpu_mask_ctx->ranges[ps].count;
+		ctr *= cpu_mask_ctx->ranges[ps].count;
+		ps = cpu_mask_ctx->ranges[ps].next;
+	}
+}
+
+#ifdef _OPENMP
+/*
+ * Like generate_keys(), but for formats whose set_key() we may call from
+ * several threads: each thread seeks to its own contiguous slice of the free
+ * key slots by candidate index (as divide_work() does for nodes) and sets
+ * those keys.  The placeholders are then left at the last candidate set, as
+ * generate_keys() would leave them, so save/restore works the same.
+ * Returns -1 if the cracker wants the keys one by one after all.
+ */
+static int generate_keys_parallel(mask_cpu_context *cpu_mask_ctx,
+			  unsigned long long *my_candidates)
+{
+	int chain[MAX_NUM_MASK_PLHDR + 1];
+	int n, ps, first, slots;
+	unsigned long long total, next;
+	int utf8 = mask_has_8bit &&
+		(options.internal_cp != UTF_8 && options.target_enc == UTF_8);
+
+	n = 0;
+	total = 1;
+	next = 0;
+	for (ps = cpu_mask_ctx->ps1; ps != MAX_NUM_MASK_PLHDR;
+	     ps = ranges(ps).next) {
+		next += ranges(ps).iter * total;
+		total *= ranges(ps).count;
+		chain[n++] = ps;
+	}
+
+	while ((slots = crk_key_slots(&first))) {
+		unsigned long long left = total - next;
+
+		if (options.node_count && *my_candidates < left)
+			left = *my_candidates;
+		if (!left) {
+			seek_offset(cpu_mask_ctx, next % total);
+			return 0;
+		}
+		if (slots > left)
+			slots = left;
+
+#pragma omp parallel
+		{
+			int t = omp_get_thread_num(), nt = omp_get_num_threads();
+			int from = (long long)slots * t / nt;
+			int to = (long long)slots * (t + 1) / nt;
+			unsigned char iter[MAX_NUM_MASK_PLHDR + 1];
+			char key[PLAINTEXT_BUFFER_SIZE];
+			char out[PLAINTEXT_BUFFER_SIZE + 1];
+			unsigned long long x = next + from;
+			int j, k;
+
+			strcpy(key, template_key);
+			for (j = 0; j < n; j++) {
+				mask_range *r = &ranges(chain[j]);
+
+				iter[j] = x % r->count;
+				x /= r->count;
+				key[r->pos + r->offset] = r->chars[iter[j]];
+			}
+
+			for (k = from; k < to; k++) {
+				mask_fmt->methods.set_key(utf8 ?
+					cp_to_utf8_r(key, out, fmt_maxlen) :
+					key, first + k);
+
+				for (j = 0; j < n; j++) {
+					mask_range *r = &ranges(chain[j]);
+
+					if (++iter[j] == r->count)
+						iter[j] = 0;
+					key[r->pos + r->offset] =
+						r->chars[iter[j]];
+					if (iter[j])
+						break;
+				}
+			}
+		}
+
+		next += slots;
+		if (options.node_count)
+			*my_candidates -= slots;
+
+		seek_offset(cpu_mask_ctx, next - 1);
+		if (crk_add_keys(slots))
+			return 1;
+	}
+
+	return -1;
+}
+#endif
+
 static int generate_keys(mask_cpu_context *cpu_mask_ctx,
 			  unsigned long long *my_candidates)
 {
@@ -1553,6 +1673,16 @@ static int generate_keys(mask_cpu_context *cpu_mask_ctx,
 				return 1; \
 	} while(0)
 
+#ifdef _OPENMP
+	if (!(options.flags & FLG_MASK_STACKED) && !f_filter &&
+	    omp_get_max_threads() > 1) {
+		int ret = generate_keys_parallel(cpu_mask_ctx, my_candidates);
+
+		if (ret >= 0)
+			return ret;
+	}
+#endif
+
 	ps1 = cpu_mask_ctx->ps1;
 	ps2 = cpu_mask_ctx->ranges[ps1].next;
 	ps3 = cpu_mask_ctx->ranges[ps2].next;
@@ -1744,23 +1874,32 @@ static void skip_position(mask_cpu_context *cpu_mask_ctx, int *arr)
 		}
 }
 
-static unsigned long long divide_work(mask_cpu_context *cpu_mask_ctx)
+/* Number of candidates for the current length */
+static unsigned long long keyspace(mask_cpu_context *cpu_mask_ctx)
 {
-	unsigned long long offset, my_candidates, total_candidates, ctr;
+	unsigned long long total = 1;
 	int ps;
-	double fract;
-
-	fract = (double)(options.node_max - options.node_min + 1) /
-		options.node_count;
 
-	offset = 1;
 	ps = cpu_mask_ctx->ps1;
 	while(ps != MAX_NUM_MASK_PLHDR) {
 		if (cpu_mask_ctx->ranges[ps].pos < max_keylen)
-			offset *= cpu_mask_ctx->ranges[ps].count;
+			total *= cpu_mask_ctx->ranges[ps].count;
 		ps = cpu_mask_ctx->ranges[ps].next;
 	}
 
+	return total;
+}
+
+static unsigned long long divide_work(mask_cpu_context *cpu_mask_ctx)
+{
+	unsigned long long offset, my_candidates, total_candidates;
+	double fract;
+
+	fract = (double)(options.node_max - options.node_min + 1) /
+		options.node_count;
+
+	offset = keyspace(cpu_mask_ctx);
+
 	total_candidates = offset;
 	offset *= fract;
 	my_candidates = offset;
@@ -1777,18 +1916,46 @@ static unsigned long long divide_work(mask_cpu_context *cpu_mask_ctx)
 		error();
 	}
 
-	ctr = 1;
-	ps = cpu_mask_ctx->ps1;
-	while(ps != MAX_NUM_MASK_PLHDR) {
-		cpu_mask_ctx->ranges[ps].iter = (offset / ctr) %
-			cpu_mask_ctx->ranges[ps].count;
-		ctr *= cpu_mask_ctx->ranges[ps].count;
-		ps = cpu_mask_ctx->ranges[ps].next;
-	}
+	seek_offset(cpu_mask_ctx, offset);
 
 	return my_candidates;
 }
 
+/*
+ * Processes the chunks we get for this length (phase) until we get one for a
+ * later length, or there's no more work.
+ */
+static int wq_generate_keys(mask_cpu_context *cpu_mask_ctx, int phase)
+{
+	unsigned long long total, per, offset;
+
+	while (1) {
+		if (wq_need) {
+			wq_chunk = workq_next(&wq_resumed);
+			wq_need = 0;
+		}
+		if (wq_chunk / wq_parts > phase)
+			return 0;
+
+		if (wq_chunk / wq_parts == phase) {
+			if (!wq_resumed) {
+				total = keyspace(cpu_mask_ctx);
+				per = (total + wq_parts - 1) / wq_parts;
+				offset = per * (wq_chunk % wq_parts);
+				if (offset > total)
+					offset = total;
+				cand = total - offset < per ?
+					total - offset : per;
+				seek_offset(cpu_mask_ctx, offset);
+			}
+			wq_resumed = 0;
+			if (cand && generate_keys(cpu_mask_ctx, &cand))
+				return 1;
+		}
+		wq_need = 1;
+	}
+}
+
 /*
  * When iterating over lengths, The progress shows percent cracked of all
  * lengths up to and including the current one, while the ETA shows the
@@ -1889,6 +2056,9 @@ void mask_fix_state(void)
 	rec_len = mask_cur_len;
 	for (i = 0; i < rec_ctx.count; i++)
 		rec_ctx.ranges[i].iter = cpu_mask_ctx.ranges[i].iter;
+
+	if (wq_parts)
+		workq_fix_state();
 }
 
 void remove_slash(char *mask)
@@ -2229,6 +2399,10 @@ void mask_init(struct db_main *db, char *unprocessed_mask)
 
 	skip_position(&cpu_mask_ctx, mask_skip_ranges);
 
+	if (workq_chunks && !(options.flags & FLG_MASK_STACKED) &&
+	    !(options.flags & FLG_TEST_CHK))
+		wq_parts = workq_chunks * options.fork;
+
 	/* If running hybrid (stacked), we let the parent mode distribute */
 	if (options.node_count && !(options.flags & FLG_MASK_STACKED))
 		cand = divide_work(&cpu_mask_ctx);
@@ -2307,6 +2481,15 @@ int do_mask_crack(const char *extern_key)
 
 		restored_len = 0;
 
+		/* Our first chunk may be for a shorter length than restored */
+		if (wq_parts) {
+			wq_chunk = workq_next(&wq_resumed);
+			wq_need = 0;
+			if (!wq_resumed)
+				mask_cur_len = options.req_minlength +
+					wq_chunk / wq_parts;
+		}
+
 		if (mask_cur_len == 0) {
 			if (crk_process_key(fmt_null_key))
 				return 1;
@@ -2326,6 +2509,11 @@ int do_mask_crack(const char *extern_key)
 			generate_template_key(mask, extern_key, key_len,
 					      &parsed_mask, &cpu_mask_ctx);
 
+			if (wq_parts) {
+				mask_tot_cand = keyspace(&cpu_mask_ctx) /
+					options.node_count *
+					mask_int_cand.num_int_cand;
+			} else
 			if (options.node_count && !(options.flags & FLG_MASK_STACKED)) {
 				if (restored) {
 					restored = 0;
@@ -2343,6 +2531,10 @@ int do_mask_crack(const char *extern_key)
 			if (options.flags & FLG_TEST_CHK) {
 				if (bench_generate_keys(&cpu_mask_ctx, &cand))
 					return 1;
+			} else if (wq_parts) {
+				if (wq_generate_keys(&cpu_mask_ctx,
+				    i - options.req_minlength))
+					return 1;
 			} else {
 				if (generate_keys(&cpu_mask_ctx, &cand))
 					return 1;
@@ -2386,6 +2578,9 @@ int do_mask_crack(const char *extern_key)
 		if (options.flags & FLG_TEST_CHK) {
 			if (bench_generate_keys(&cpu_mask_ctx, &cand))
 				return 1;
+		} else if (wq_parts) {
+			if (wq_generate_keys(&cpu_mask_ctx, 0))
+				return 1;
 		} else {
 			if (generate_keys(&cpu_mask_ctx, &cand))
 				return 1;
@@ -166,6 +166,7 @@
 #endif
 #define LOG_SUFFIX			".log"
 #define RECOVERY_SUFFIX			".rec"
+#define LOADER_CACHE_SUFFIX		".ldc"
 #define WORDLIST_NAME			"$JOHN/password.lst"
 
 /*
@@ -301,6 +302,12 @@ extern unsigned int password_hash_thresholds[PASSWORD_HASH_SIZES];
  */
 #define LDR_HASH_COLLISIONS_MAX		1000
 
+/*
+ * Minimum size of what's left of a hash file for it to be validated by
+ * several processes at once (when LoaderProcesses is set in john.conf).
+ */
+#define LDR_PARALLEL_MIN_SIZE		0x1000000
+
 /*
  * How many bitmap entries should the cracker prefetch at once.  Set this to 0
  * to disable prefetching.
@@ -346,6 +353,23 @@ extern unsigned int password_hash_thresholds[PASSWORD_HASH_SIZES];
  */
 #define RULE_RANGES_MAX			16
 
+/*
+ * Number of rules an input line (with character ranges) expands to beyond
+ * which they're not all checked for validity on startup, the rest being
+ * counted arithmetically.  Any invalid ones are then rejected when used.
+ */
+#define RULES_CHECK_MAX			0x10000
+
+/*
+ * Number of words rules_apply_batch() works on at once.
+ */
+#define RULES_BATCH			64
+
+/*
+ * Number of words rules_apply_parallel() splits between threads at once.
+ */
+#define RULES_OMP_BATCH			0x400
+
 /*
  * Buffer size for words while applying rules, should be at least as large
  * as PLAINTEXT_BUFFER_SIZE.
@@ -397,6 +421,20 @@ extern unsigned int password_hash_thresholds[PASSWORD_HASH_SIZES];
 /* Default maximum size of wordlist memory buffer. */
 #define WORDLIST_BUFFER_DEFAULT		0x40000000
 
+/*
+ * Maximum number of candidates, and buffer size for them, in each of the two
+ * blocks passed from the rules thread to the cracker (RulesPipeline = Y).
+ */
+#define WORDLIST_PIPE_KEYS		0x2000
+#define WORDLIST_PIPE_SIZE		0x40000
+
+/*
+ * How much of a memory-mapped wordlist to have read in ahead of where we are
+ * (a power of two), and the stdio buffer size for one that isn't mapped.
+ */
+#define WORDLIST_READ_AHEAD		0x1000000
+#define WORDLIST_STDIO_BUFFER		0x100000
+
 /* Number of custom Mask placeholders */
 #define MAX_NUM_CUST_PLHDR		9
 
@@ -0,0 +1,493 @@
+/*
+ * This file is part of John the Ripper password cracker.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted.
+ *
+ * There's ABSOLUTELY NO WARRANTY, express or implied.
+ */
+
+#if AC_BUILT
+#include "autoconfig.h"
+#endif
+
+#define NEED_OS_FLOCK
+#include "os.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#if (!AC_BUILT || HAVE_UNISTD_H) && !_MSC_VER
+#include <unistd.h>
+#endif
+#ifdef _MSC_VER
+#include <io.h>
+#endif
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#if OS_FLOCK
+#include <sys/file.h>
+#endif
+
+#include "arch.h"
+#include "jumbo.h"
+#include "misc.h"
+#include "params.h"
+#include "path.h"
+#include "memory.h"
+#include "config.h"
+#include "options.h"
+#include "logger.h"
+#include "pot_index.h"
+#include "memdbg.h"
+
+#ifndef O_BINARY
+#define O_BINARY			0
+#endif
+
+#define POT_INDEX_SUFFIX		".idx"
+#define POT_INDEX_MAGIC			"JtRpix1\n"
+
+/* Pot file read size when indexing */
+#define POT_INDEX_READ_SIZE		0x100000
+
+struct pot_index_header {
+	char magic[8];
+/* Pot file size covered, always at the end of a line */
+	uint64_t covered;
+/* Number of records sorted by hash, the rest being in pot file order */
+	uint64_t sorted;
+/* Sum of record_check() for all records */
+	uint64_t check;
+};
+
+struct pot_index_record {
+	uint64_t hash, offset;
+};
+
+/* The open index, as used by the loader */
+static FILE *pot_file;
+static struct pot_index_record *sorted, *tail;
+static size_t sorted_count, tail_count;
+
+/* The logger's own descriptor for the index file, or -1 if not updating it */
+static int log_fd = -1;
+
+static char *idx_name(char *pot_name)
+{
+	char *name = path_expand(pot_name);
+	char *res = mem_alloc_tiny(strlen(name) + sizeof(POT_INDEX_SUFFIX),
+	    MEM_ALIGN_NONE);
+
+	strcpy(res, name);
+	strcat(res, POT_INDEX_SUFFIX);
+
+	return res;
+}
+
+/*
+ * Same locking as the logger does while writing to the pot file.
+ */
+static void pot_lock(int fd, int unlock)
+{
+#if FCNTL_LOCKS
+	struct flock lock;
+
+	memset(&lock, 0, sizeof(lock));
+	lock.l_type = unlock ? F_UNLCK : F_WRLCK;
+	while (fcntl(fd, unlock ? F_SETLK : F_SETLKW, &lock)) {
+		if (errno != EINTR)
+			pexit("fcntl");
+	}
+#elif OS_FLOCK
+	while (flock(fd, unlock ? LOCK_UN : LOCK_EX)) {
+		if (errno != EINTR)
+			pexit("flock");
+	}
+#endif
+}
+
+/*
+ * 64-bit FNV-1a of a pot line's ciphertext field.
+ */
+static uint64_t pot_index_hash(const char *p, const char *end)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	char sep = options.loader.field_sep_char;
+
+	while (p < end && *p != sep) {
+		hash ^= (unsigned char)*p++;
+		hash *= 0x100000001b3ULL;
+	}
+
+	return hash;
+}
+
+/*
+ * Order independent, so that it can be updated as records are appended.
+ */
+static uint64_t record_check(struct pot_index_record *record)
+{
+	return (record->hash ^ record->offset) * 0x9e3779b97f4a7c15ULL;
+}
+
+static uint64_t records_check(struct pot_index_record *records, size_t count)
+{
+	uint64_t sum = 0;
+
+	while (count--)
+		sum += record_check(records++);
+
+	return sum;
+}
+
+static int cmp_record(const void *p1, const void *p2)
+{
+	const struct pot_index_record *r1 = p1, *r2 = p2;
+
+	if (r1->hash != r2->hash)
+		return r1->hash < r2->hash ? -1 : 1;
+	if (r1->offset != r2->offset)
+		return r1->offset < r2->offset ? -1 : 1;
+	return 0;
+}
+
+static int read_loop(int fd, void *buffer, size_t count)
+{
+	size_t offset = 0;
+	int block;
+
+	while (offset < count) {
+		block = read(fd, (char *)buffer + offset, count - offset);
+		if (block <= 0)
+			return -1;
+		offset += block;
+	}
+
+	return 0;
+}
+
+/*
+ * Adds records for the complete lines in the pot file from *covered on, and
+ * advances *covered past the last one.
+ */
+static void pot_index_scan(FILE *file, int64_t size, uint64_t *covered,
+	struct pot_index_record **records, size_t *count)
+{
+	char *buffer = mem_alloc(POT_INDEX_READ_SIZE);
+	size_t have = 0, alloc = *count;
+	int64_t start = *covered;
+	int skipping = 0;
+
+	if (jtr_fseek64(file, start, SEEK_SET) < 0)
+		pexit("fseek");
+
+	while (start + (int64_t)have < size) {
+		char *p, *nl;
+		size_t block = POT_INDEX_READ_SIZE - have;
+
+		if ((int64_t)block > size - start - (int64_t)have)
+			block = size - start - have;
+		if (!(block = fread(buffer + have, 1, block, file)))
+			break;
+		have += block;
+
+		p = buffer;
+		while ((nl = memchr(p, '\n', buffer + have - p))) {
+			if (skipping)
+				skipping = 0;
+			else {
+				if (*count >= alloc) {
+					alloc = alloc ? alloc * 2 : 0x10000;
+					*records = mem_realloc(*records,
+					    alloc * sizeof(**records));
+				}
+				(*records)[*count].hash =
+				    pot_index_hash(p, nl);
+				(*records)[*count].offset = start + (p - buffer);
+				(*count)++;
+			}
+			p = nl + 1;
+		}
+
+/*
+ * A line longer than our buffer: its ciphertext field is in there, as the
+ * logger truncates those, so index it now and skip the rest.
+ */
+		if (p == buffer && have == POT_INDEX_READ_SIZE) {
+			if (!skipping) {
+				if (*count >= alloc) {
+					alloc = alloc ? alloc * 2 : 0x10000;
+					*records = mem_realloc(*records,
+					    alloc * sizeof(**records));
+				}
+				(*records)[*count].hash =
+				    pot_index_hash(p, buffer + have);
+				(*records)[*count].offset = start;
+				(*count)++;
+				skipping = 1;
+			}
+			p = buffer + have;
+		}
+
+		memmove(buffer, p, buffer + have - p);
+		start += p - buffer;
+		have -= p - buffer;
+		if (!skipping)
+			*covered = start;
+	}
+
+/* The long line isn't complete yet */
+	if (skipping)
+		(*count)--;
+
+	MEM_FREE(buffer);
+}
+
+/*
+ * Writes a new index file with all records sorted and puts it in place.
+ */
+static int pot_index_write(char *name, struct pot_index_header *header,
+	struct pot_index_record *records, size_t count)
+{
+	char *tmp_name = mem_alloc(strlen(name) + 5);
+	FILE *file;
+	int error;
+
+	strcpy(tmp_name, name);
+	strcat(tmp_name, ".tmp");
+
+	header->sorted = count;
+	if (!(file = fopen(tmp_name, "wb"))) {
+		MEM_FREE(tmp_name);
+		return -1;
+	}
+	error = fwrite(header, sizeof(*header), 1, file) != 1 ||
+	    (count && fwrite(records, sizeof(*records), count, file) != count);
+	if (fclose(file))
+		error = 1;
+	if (!error && rename(tmp_name, name))
+		error = 1;
+	if (error)
+		unlink(tmp_name);
+
+	MEM_FREE(tmp_name);
+	return error ? -1 : 0;
+}
+
+int pot_index_open(char *pot_name, int64_t *indexed)
+{
+	struct pot_index_header header;
+	struct pot_index_record *records = NULL;
+	struct stat pot_stat, idx_stat;
+	size_t count = 0, old_count = 0;
+	char *name;
+	int pot_fd, idx_fd, valid;
+
+	if (pot_file ||
+	    !cfg_get_bool(SECTION_OPTIONS, NULL, "PotIndex", 0))
+		return 1;
+
+	if ((pot_fd = open(path_expand(pot_name), O_RDWR | O_BINARY)) < 0)
+		return 1;
+	if (!(pot_file = fdopen(pot_fd, "rb"))) {
+		close(pot_fd);
+		return 1;
+	}
+
+/*
+ * Keep other instances from writing to either file while we're at it.
+ */
+	pot_lock(pot_fd, 0);
+
+	name = idx_name(pot_name);
+	memset(&idx_stat, 0, sizeof(idx_stat));
+	if (fstat(pot_fd, &pot_stat) ||
+	    (idx_fd = open(name, O_RDWR | O_CREAT | O_BINARY, 0600)) < 0) {
+		pot_lock(pot_fd, 1);
+		fclose(pot_file);
+		pot_file = NULL;
+		return 1;
+	}
+
+	valid = !fstat(idx_fd, &idx_stat) &&
+	    idx_stat.st_size >= sizeof(header) &&
+	    !((idx_stat.st_size - sizeof(header)) % sizeof(*records)) &&
+	    !read_loop(idx_fd, &header, sizeof(header)) &&
+	    !memcmp(header.magic, POT_INDEX_MAGIC, sizeof(header.magic)) &&
+	    header.covered <= (uint64_t)pot_stat.st_size &&
+	    header.sorted <=
+	    (idx_stat.st_size - sizeof(header)) / sizeof(*records);
+
+	if (valid && header.covered) {
+		char c;
+
+		valid = !jtr_fseek64(pot_file, header.covered - 1, SEEK_SET) &&
+		    fread(&c, 1, 1, pot_file) == 1 && c == '\n';
+	}
+
+	if (valid) {
+		old_count = count =
+		    (idx_stat.st_size - sizeof(header)) / sizeof(*records);
+		records = mem_alloc((count ? count : 1) * sizeof(*records));
+		if ((count && read_loop(idx_fd, records,
+		    count * sizeof(*records))) ||
+		    records_check(records, count) != header.check)
+			valid = 0;
+	}
+
+	if (!valid) {
+		if (idx_stat.st_size)
+			log_event("- Pot file index is invalid, rebuilding");
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, POT_INDEX_MAGIC, sizeof(header.magic));
+		MEM_FREE(records);
+		old_count = count = 0;
+	}
+
+	pot_index_scan(pot_file, pot_stat.st_size, &header.covered,
+	    &records, &count);
+	header.check += records_check(&records[old_count], count - old_count);
+
+/*
+ * Sort the records once too many were added past the sorted ones, or else
+ * just append the new ones.
+ */
+	if (!valid || count - header.sorted > header.sorted / 16) {
+		qsort(records, count, sizeof(*records), cmp_record);
+		if (pot_index_write(name, &header, records, count))
+			log_event("- Can't write pot file index: %s",
+			    strerror(errno));
+	} else if (count > old_count) {
+		if (lseek(idx_fd, 0, SEEK_SET) < 0 ||
+		    write_loop(idx_fd, (char *)&header, sizeof(header)) < 0 ||
+		    lseek(idx_fd, sizeof(header) + old_count *
+		    sizeof(*records), SEEK_SET) < 0 ||
+		    write_loop(idx_fd, (char *)&records[old_count],
+		    (count - old_count) * sizeof(*records)) < 0)
+			log_event("- Can't update pot file index: %s",
+			    strerror(errno));
+	}
+
+	close(idx_fd);
+	pot_lock(pot_fd, 1);
+
+	sorted = records;
+	sorted_count = header.sorted;
+	tail = &records[sorted_count];
+	tail_count = count - sorted_count;
+	qsort(tail, tail_count, sizeof(*tail), cmp_record);
+
+	*indexed = header.covered;
+
+	log_event("- Using pot file index, %" PRIu64 " lines", (uint64_t)count);
+
+	return 0;
+}
+
+int pot_index_is_open(void)
+{
+	return pot_file != NULL;
+}
+
+static void pot_index_find(struct db_main *db, const char *ciphertext,
+	size_t len, uint64_t hash, struct pot_index_record *records,
+	size_t count, void (*process_line)(struct db_main *db, char *line))
+{
+	char line_buf[LINE_BUFFER_SIZE], *line;
+	size_t lo = 0, hi = count;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+
+		if (records[mid].hash < hash)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	for (; lo < count && records[lo].hash == hash; lo++) {
+		if (jtr_fseek64(pot_file, records[lo].offset, SEEK_SET) ||
+		    !(line = fgetll(line_buf, sizeof(line_buf), pot_file)))
+			continue;
+		if (!strncmp(line, ciphertext, len) &&
+		    line[len] == options.loader.field_sep_char)
+			process_line(db, line);
+		if (line != line_buf)
+			MEM_FREE(line);
+	}
+}
+
+void pot_index_lookup(struct db_main *db, const char *ciphertext,
+	void (*process_line)(struct db_main *db, char *line))
+{
+	size_t len = strlen(ciphertext);
+	uint64_t hash = pot_index_hash(ciphertext, ciphertext + len);
+
+	pot_index_find(db, ciphertext, len, hash, sorted, sorted_count,
+	    process_line);
+	pot_index_find(db, ciphertext, len, hash, tail, tail_count,
+	    process_line);
+}
+
+void pot_index_close(void)
+{
+	if (!pot_file)
+		return;
+
+	fclose(pot_file);
+	pot_file = NULL;
+	MEM_FREE(sorted);
+	tail = NULL;
+	sorted_count = tail_count = 0;
+}
+
+void pot_index_log_init(char *pot_name)
+{
+	if (log_fd >= 0 ||
+	    !cfg_get_bool(SECTION_OPTIONS, NULL, "PotIndex", 0))
+		return;
+
+/*
+ * Only an existing index is updated, it's up to the loader to create one.
+ */
+	log_fd = open(idx_name(pot_name), O_RDWR | O_BINARY);
+}
+
+void pot_index_log(long pos, const char *buffer, int count)
+{
+	struct pot_index_header header;
+	struct pot_index_record record;
+	const char *p = buffer, *end = buffer + count, *nl;
+	off_t size;
+
+	if (log_fd < 0)
+		return;
+
+/*
+ * If someone else wrote to the pot file without updating the index, leave
+ * it to the loader to catch up.
+ */
+	if (lseek(log_fd, 0, SEEK_SET) < 0 ||
+	    read_loop(log_fd, &header, sizeof(header)) ||
+	    memcmp(header.magic, POT_INDEX_MAGIC, sizeof(header.magic)) ||
+	    header.covered != (uint64_t)pos ||
+	    (size = lseek(log_fd, 0, SEEK_END)) < 0 ||
+	    (size - sizeof(header)) % sizeof(record))
+		return;
+
+	while (p < end && (nl = memchr(p, '\n', end - p))) {
+		record.hash = pot_index_hash(p, nl);
+		record.offset = pos + (p - buffer);
+		if (write_loop(log_fd, (char *)&record, sizeof(record)) < 0)
+			return;
+		header.check += record_check(&record);
+		p = nl + 1;
+	}
+
+	header.covered = pos + (p - buffer);
+	if (lseek(log_fd, 0, SEEK_SET) >= 0)
+		write_loop(log_fd, (char *)&header, sizeof(header));
+}
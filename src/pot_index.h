@@ -0,0 +1,71 @@
+/*
+ * This file is part of John the Ripper password cracker.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted.
+ *
+ * There's ABSOLUTELY NO WARRANTY, express or implied.
+ */
+
+/*
+ * Optional binary index for the pot file, kept next to it (john.pot.idx).
+ *
+ * It maps a 64-bit hash of each pot line's ciphertext field (exactly as
+ * written by log_guess()) to that line's offset, so the loader can look up
+ * the hashes it has loaded instead of parsing the whole pot file.  The index
+ * only ever selects candidate lines; those are then read from the pot file
+ * and processed the usual way, so a damaged index can make us miss cracked
+ * hashes (until it's rebuilt), but never get a wrong match.
+ *
+ * The file starts with a header holding the pot file offset up to which
+ * lines are indexed, followed by records sorted by hash, followed by records
+ * appended by the logger as it writes to the pot file.  Lines appended to the
+ * pot file by other means are indexed the next time it's opened.
+ */
+
+#ifndef _JOHN_POT_INDEX_H
+#define _JOHN_POT_INDEX_H
+
+#include <stdint.h>
+
+#include "loader.h"
+
+/*
+ * Opens the index for the named pot file, bringing it up to date with the
+ * pot file (or rebuilding it) first, and sets *indexed to the size of the
+ * pot file it covers.  Returns zero on success, or non-zero if it's not to
+ * be used (disabled in john.conf, no pot file, or errors) in which case the
+ * caller should read the pot file instead.
+ */
+extern int pot_index_open(char *pot_name, int64_t *indexed);
+
+/*
+ * Returns non-zero if an index is open.
+ */
+extern int pot_index_is_open(void);
+
+/*
+ * Reads each pot line whose ciphertext is the one given (which must be in
+ * the form log_guess() writes it) and passes it to process_line().
+ */
+extern void pot_index_lookup(struct db_main *db, const char *ciphertext,
+	void (*process_line)(struct db_main *db, char *line));
+
+/*
+ * Closes the index.
+ */
+extern void pot_index_close(void);
+
+/*
+ * Called by the logger on opening the pot file.  Decides whether to keep
+ * the index updated as we write to the pot file.
+ */
+extern void pot_index_log_init(char *pot_name);
+
+/*
+ * Called by the logger with the pot file still locked, right after it has
+ * written count bytes of complete lines from buffer at offset pos.
+ */
+extern void pot_index_log(long pos, const char *buffer, int count);
+
+#endif
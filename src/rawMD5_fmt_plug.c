@@ -23,6 +23,8 @@ john_register_one(&fmt_rawMD5);
 #include "johnswap.h"
 #include "formats.h"
 #include "base64_convert.h"
+#include "options.h"
+#include "mask_ext.h"
 
 #if !FAST_FORMATS_OMP
 #undef _OPENMP
@@ -101,6 +103,13 @@ static struct fmt_tests tests[] = {
 #define MIN_KEYS_PER_CRYPT		NBKEYS
 #define MAX_KEYS_PER_CRYPT		NBKEYS
 #define GETPOS(i, index)		( (index&(SIMD_COEF_32-1))*4 + ((i)&(0xffffffff-3))*SIMD_COEF_32 + ((i)&3) + (unsigned int)index/SIMD_COEF_32*MD5_BUF_SIZ*4*SIMD_COEF_32 )
+#define GETWORD(i, index)		( ((index)&(SIMD_COEF_32-1)) + (i)*SIMD_COEF_32 + (unsigned int)(index)/SIMD_COEF_32*MD5_BUF_SIZ*SIMD_COEF_32 )
+/*
+ * In mask mode, how many candidates we'd like mask.c to leave for us to
+ * generate per key, by overwriting up to MASK_FMT_INT_PLHDR characters of
+ * each key right in saved_key.
+ */
+#define INT_CAND_TARGET			100
 #else
 #define PLAINTEXT_LENGTH		125
 #define MIN_KEYS_PER_CRYPT		1
@@ -110,6 +119,14 @@ static struct fmt_tests tests[] = {
 #ifdef SIMD_COEF_32
 static uint32_t (*saved_key)[MD5_BUF_SIZ*NBKEYS];
 static uint32_t (*crypt_key)[DIGEST_SIZE/4*NBKEYS];
+/*
+ * With internal mask candidates, crypt_key holds int_cand blocks of results
+ * for each block of keys, so an index into it is one for the keys and the
+ * int_cand table combined, see get_key().
+ */
+static int max_keys, int_cand = 1, int_cand_count;
+static int int_cand_pos[MASK_FMT_INT_PLHDR];
+static mask_char4 *int_cands;
 #else
 static int (*saved_len);
 static char (*saved_key)[PLAINTEXT_LENGTH + 1];
@@ -138,15 +155,63 @@ static void init(struct fmt_main *self)
 	                             sizeof(*saved_key), MEM_ALIGN_SIMD);
 	crypt_key = mem_calloc_align(self->params.max_keys_per_crypt/NBKEYS,
 	                             sizeof(*crypt_key), MEM_ALIGN_SIMD);
+	max_keys = self->params.max_keys_per_crypt;
+
+	if ((options.flags & FLG_MASK_CHK) &&
+	    !(options.flags & (FLG_MASK_STACKED | FLG_TEST_CHK)) &&
+	    options.req_minlength < 0 && !options.req_maxlength &&
+	    !options.external)
+		mask_int_cand_target = INT_CAND_TARGET;
 #endif
 }
 
+#ifdef SIMD_COEF_32
+/*
+ * Called after mask_init(), so we know if mask.c took us up on the offer.
+ * If it did, we take fewer keys per crypt_all() since each of them yields
+ * int_cand candidates.
+ */
+static void reset(struct db_main *db)
+{
+	int i, keys;
+
+	int_cand = 1;
+	int_cand_count = 0;
+	MEM_FREE(int_cands);
+	if (!db)
+		return;
+
+	if (mask_int_cand.num_int_cand > 1) {
+		int_cand = mask_int_cand.num_int_cand;
+		int_cands = mem_alloc(int_cand * sizeof(*int_cands));
+		memcpy(int_cands, mask_int_cand.int_cand,
+		       int_cand * sizeof(*int_cands));
+		for (i = 0; i < MASK_FMT_INT_PLHDR &&
+		     mask_skip_ranges[i] != -1; i++)
+			int_cand_pos[int_cand_count++] =
+				mask_int_cand.int_cpu_mask_ctx->
+				ranges[mask_skip_ranges[i]].pos;
+	}
+
+	keys = max_keys / int_cand / NBKEYS * NBKEYS;
+	if (keys < db->format->params.min_keys_per_crypt)
+		keys = db->format->params.min_keys_per_crypt;
+	db->format->params.max_keys_per_crypt = keys;
+
+	MEM_FREE(crypt_key);
+	crypt_key = mem_calloc_align(keys / NBKEYS * int_cand,
+	                             sizeof(*crypt_key), MEM_ALIGN_SIMD);
+}
+#endif
+
 static void done(void)
 {
 	MEM_FREE(crypt_key);
 	MEM_FREE(saved_key);
 #ifndef SIMD_COEF_32
 	MEM_FREE(saved_len);
+#else
+	MEM_FREE(int_cands);
 #endif
 }
 
@@ -330,12 +395,25 @@ static void set_key(char *key, int index)
 static char *get_key(int index)
 {
 	static char out[PLAINTEXT_LENGTH + 1];
-	unsigned int i;
-	uint32_t len = ((uint32_t*)saved_key)[14*SIMD_COEF_32 + (index&(SIMD_COEF_32-1)) + (unsigned int)index/SIMD_COEF_32*MD5_BUF_SIZ*SIMD_COEF_32] >> 3;
+	unsigned int i, int_index = 0;
+	uint32_t len;
+
+	if (int_cand > 1) {
+		int_index = (unsigned int)index / NBKEYS % int_cand;
+		index = (unsigned int)index / NBKEYS / int_cand * NBKEYS +
+			(unsigned int)index % NBKEYS;
+	}
+
+	len = ((uint32_t*)saved_key)[GETWORD(14, index)] >> 3;
 
 	for (i=0;i<len;i++)
 		out[i] = ((char*)saved_key)[GETPOS(i, index)];
 	out[i] = 0;
+
+	for (i = 0; i < int_cand_count; i++)
+		if (int_cand_pos[i] < len)
+			out[int_cand_pos[i]] = int_cands[int_index].x[i];
+
 	return (char*)out;
 }
 #else
@@ -351,6 +429,50 @@ static char *get_key(int index)
 #define SSEi_REVERSE_STEPS 0
 #endif
 
+#ifdef SIMD_COEF_32
+/*
+ * Hashes every key with each of the internal mask candidates, patching them
+ * into saved_key in place.  The unused slots in the last block get a copy of
+ * the last key, so all candidates we return are ones we were given.
+ */
+static int crypt_all_int_cand(int *pcount)
+{
+	const int count = *pcount;
+	int index;
+	int loops = (count + NBKEYS - 1) / NBKEYS;
+	uint32_t *keys = (uint32_t*)saved_key;
+
+	for (index = count; index % NBKEYS; index++) {
+		unsigned int i;
+
+		for (i = 0; i < MD5_BUF_SIZ; i++)
+			keys[GETWORD(i, index)] = keys[GETWORD(i, count - 1)];
+	}
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for (index = 0; index < loops; index++) {
+		unsigned char *block = (unsigned char*)saved_key[index];
+		int i, j, k;
+
+		for (j = 0; j < int_cand; j++) {
+			for (i = 0; i < int_cand_count; i++) {
+				unsigned char c = int_cands[j].x[i];
+
+				for (k = 0; k < NBKEYS; k++)
+					block[GETPOS(int_cand_pos[i], k)] = c;
+			}
+			SIMDmd5body(saved_key[index],
+			            crypt_key[index * int_cand + j], NULL,
+			            SSEi_REVERSE_STEPS | SSEi_MIXED_IN);
+		}
+	}
+
+	return *pcount = loops * NBKEYS * int_cand;
+}
+#endif
+
 static int crypt_all(int *pcount, struct db_salt *salt)
 {
 	const int count = *pcount;
@@ -358,6 +480,11 @@ static int crypt_all(int *pcount, struct db_salt *salt)
 
 	int loops = (count + MAX_KEYS_PER_CRYPT - 1) / MAX_KEYS_PER_CRYPT;
 
+#ifdef SIMD_COEF_32
+	if (int_cand > 1 && count)
+		return crypt_all_int_cand(pcount);
+#endif
+
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
@@ -468,7 +595,7 @@ struct fmt_main fmt_rawMD5 = {
 		MIN_KEYS_PER_CRYPT,
 		MAX_KEYS_PER_CRYPT,
 #ifdef _OPENMP
-		FMT_OMP | FMT_OMP_BAD |
+		FMT_OMP | FMT_OMP_BAD | FMT_OMP_SET_KEY |
 #endif
 		FMT_CASE | FMT_8_BIT,
 		{ NULL },
@@ -477,7 +604,11 @@ struct fmt_main fmt_rawMD5 = {
 	}, {
 		init,
 		done,
+#ifdef SIMD_COEF_32
+		reset,
+#else
 		fmt_default_reset,
+#endif
 		prepare,
 		valid,
 		split,
@@ -405,7 +405,7 @@ struct fmt_main fmt_rawSHA1 = {
 		MIN_KEYS_PER_CRYPT,
 		MAX_KEYS_PER_CRYPT,
 #ifdef _OPENMP
-		FMT_OMP | FMT_OMP_BAD |
+		FMT_OMP | FMT_OMP_BAD | FMT_OMP_SET_KEY |
 #endif
 		FMT_CASE | FMT_8_BIT | FMT_SPLIT_UNIFIES_CASE,
 		{ NULL },
@@ -469,7 +469,7 @@ struct fmt_main fmt_rawSHA1_axcrypt = {
 		MIN_KEYS_PER_CRYPT,
 		MAX_KEYS_PER_CRYPT,
 #ifdef _OPENMP
-		FMT_OMP | FMT_OMP_BAD |
+		FMT_OMP | FMT_OMP_BAD | FMT_OMP_SET_KEY |
 #endif
 		FMT_CASE | FMT_8_BIT | FMT_SPLIT_UNIFIES_CASE,
 		{ NULL },
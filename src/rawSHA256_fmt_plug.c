@@ -354,7 +354,7 @@ struct fmt_main fmt_rawSHA256 = {
 		MIN_KEYS_PER_CRYPT,
 		MAX_KEYS_PER_CRYPT,
 		FMT_CASE | FMT_8_BIT | FMT_OMP | FMT_OMP_BAD |
-		FMT_SPLIT_UNIFIES_CASE,
+		FMT_OMP_SET_KEY | FMT_SPLIT_UNIFIES_CASE,
 		{ NULL },
 		{
 			HEX_TAG,
@@ -59,6 +59,7 @@
 #include "john.h"
 #include "mask.h"
 #include "unicode.h"
+#include "workq.h"
 #ifdef HAVE_MPI
 #include "john-mpi.h"
 #include "signals.h"
@@ -399,6 +400,8 @@ void rec_save(void)
 	if (rec_save_mode3) rec_save_mode3(rec_file);
 	if (options.flags & FLG_MASK_STACKED)
 		mask_save_state(rec_file);
+	if (workq_chunks)
+		workq_save_state(rec_file);
 
 	if (ferror(rec_file)) pexit("fprintf");
 
@@ -415,6 +418,8 @@ void rec_save(void)
 	if (!options.fork && fsync(rec_fd))
 		pexit("fsync");
 #endif
+	if (workq_chunks)
+		workq_saved();
 }
 
 void rec_init_hybrid(void (*save_mode)(FILE *file)) {
@@ -462,6 +467,9 @@ void rec_done(int save)
 	if ((!save || save == -1) && unlink(path_expand(rec_name)))
 		pexit("unlink: %s", path_expand(rec_name));
 
+	if ((!save || save == -1) && john_main_process)
+		ldr_remove_cache();
+
 	if (rec_file) {
 		if (fclose(rec_file))
 			pexit("fclose");
@@ -624,6 +632,18 @@ static void restore_salt_state()
 	status.resume_salt = 1;
 }
 
+void rec_peek(void (*peek)(FILE *file))
+{
+	long pos;
+
+	if (!rec_file) return;
+
+	if ((pos = ftell(rec_file)) < 0) pexit("ftell");
+	peek(rec_file);
+	clearerr(rec_file);
+	if (fseek(rec_file, pos, SEEK_SET)) pexit("fseek");
+}
+
 void rec_restore_mode(int (*restore_mode)(FILE *file))
 {
 	char buf[128];
@@ -654,6 +674,10 @@ void rec_restore_mode(int (*restore_mode)(FILE *file))
 		if (!strcmp(buf, "slt-v1")) {
 			restore_salt_state();
 		}
+		else if (!strcmp(buf, "wrk-v1")) {
+			if (!workq_chunks || workq_restore_state(rec_file))
+				rec_format_error("work distribution");
+		}
 		fgetl(buf, sizeof(buf), rec_file);
 	}
 
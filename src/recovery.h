@@ -108,6 +108,13 @@ extern void rec_done(int save);
  */
 extern void rec_restore_args(int lock);
 
+/*
+ * Lets peek() read the rest of the file we're restoring from, then seeks back
+ * for rec_restore_mode().  Does nothing if we're not restoring.  The file is
+ * not reopened, so the lock we hold on it is kept.
+ */
+extern void rec_peek(void (*peek)(FILE *file));
+
 /*
  * Restores cracking mode specific information and closes the file.
  */
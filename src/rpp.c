@@ -319,3 +319,127 @@ char *rpp_next(struct rpp_context *ctx)
 
 	return ctx->output;
 }
+
+/*
+ * Returns the number of rules the current input line (already processed)
+ * expands to, or 0 if that can't be told without enumerating them: for
+ * ranges processed "in parallel" with preceding ones by \p alone, and for
+ * .log directives (which produce no rules, but are to be enumerated).
+ */
+static unsigned long long rpp_line_rules(struct rpp_context *ctx)
+{
+	unsigned long long rules = 1;
+	int index;
+
+	if (ctx->input->data[0] == '.')
+		return 0;
+
+	for (index = 0; index < ctx->count; index++) {
+		struct rpp_range *range = &ctx->ranges[index];
+
+		if (range->flag_p < 0)
+			return 0;
+		if (range->flag_p)
+			continue;
+		if (range->count > 1) {
+			if (rules > ~0ULL / range->count)
+				return 0;
+			rules *= range->count;
+		}
+	}
+
+	return rules;
+}
+
+/*
+ * The ranges not processed in parallel with others act as digits of the
+ * number of the rule within the input line, the last range being the least
+ * significant one.
+ */
+static unsigned long long rpp_line_number(struct rpp_context *ctx)
+{
+	unsigned long long number = 0;
+	int index;
+
+	for (index = 0; index < ctx->count; index++) {
+		struct rpp_range *range = &ctx->ranges[index];
+
+		if (!range->flag_p && range->count > 1)
+			number = number * range->count + range->index;
+	}
+
+	return number;
+}
+
+static void rpp_set_line_number(struct rpp_context *ctx,
+	unsigned long long number)
+{
+	struct rpp_range *range;
+	int index;
+
+	for (index = ctx->count - 1; index >= 0; index--) {
+		range = &ctx->ranges[index];
+		if (range->flag_p || range->count <= 1)
+			continue;
+		range->index = number % range->count;
+		number /= range->count;
+	}
+
+/* Same as in rpp_next() */
+	for (index = ctx->count - 1; index >= 0; index--) {
+		range = &ctx->ranges[index];
+		if (range->flag_p <= 0 || range->flag_p > ctx->count)
+			continue;
+		if (ctx->ranges[range->flag_p - 1].flag_p)
+			continue;
+		range->index = ctx->ranges[range->flag_p - 1].index;
+		if (range->index >= range->count)
+			range->index = range->count - 1;
+	}
+}
+
+unsigned long long rpp_line_left(struct rpp_context *ctx)
+{
+	unsigned long long rules;
+	extern int hc_logic;
+
+	if (ctx->count < 0) {
+		if (!ctx->input) return 0;
+		if (hc_logic) {
+			ctx->count = 0;
+			strcpy(ctx->output, ctx->input->data);
+		} else
+		rpp_process_rule(ctx);
+	}
+
+	if (!(rules = rpp_line_rules(ctx)))
+		return 0;
+
+	return rules - rpp_line_number(ctx);
+}
+
+int rpp_skip(struct rpp_context *ctx, unsigned long long count)
+{
+	unsigned long long left;
+
+	while (count) {
+		if (!(left = rpp_line_left(ctx))) {
+			if (!ctx->input || !rpp_next(ctx))
+				return 1;
+			count--;
+			continue;
+		}
+
+		if (count < left) {
+			rpp_set_line_number(ctx,
+			    rpp_line_number(ctx) + count);
+			break;
+		}
+
+		count -= left;
+		ctx->input = ctx->input->next;
+		ctx->count = -1;
+	}
+
+	return 0;
+}
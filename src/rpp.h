@@ -85,4 +85,19 @@ extern int rpp_init(struct rpp_context *ctx, char *subsection);
  */
 extern char *rpp_next(struct rpp_context *ctx);
 
+/*
+ * Moves on by count rules, same as that many rpp_next() calls would, but
+ * without producing the rules skipped over unless their number within an
+ * input line can't be computed.  Returns a non-zero value if there weren't
+ * as many rules left.
+ */
+extern int rpp_skip(struct rpp_context *ctx, unsigned long long count);
+
+/*
+ * Returns the number of rules left to be returned for the current input
+ * line, or 0 if that can't be computed (see rpp_skip()) or there are no more
+ * rules.
+ */
+extern unsigned long long rpp_line_left(struct rpp_context *ctx);
+
 #endif
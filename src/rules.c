@@ -7,6 +7,9 @@
 
 #include <stdio.h>
 #include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "arch.h"
 #include "misc.h"
@@ -1139,11 +1142,944 @@ static void rules_init_length(int max_length)
 	rules_vars['z'] = INFINITE_LENGTH;
 }
 
+/*
+ * A rule as compiled by rules_reject() for rules_apply() to run, so that the
+ * rule text is parsed once rather than for every word.  Character classes
+ * are resolved to their tables (single characters get a table as well) and
+ * positions given as constants are looked up in advance.  Only the commands
+ * usable in wordlist mode with John's own logic are compiled; if a rule has
+ * any other, the rule text is interpreted as before.  Each command does
+ * exactly what the corresponding case in rules_apply() does.
+ */
+struct rules_op {
+	char cmd;
+	char value[3];
+	unsigned char count;
+/* Positions, or the names of the variables to take them from at run time */
+	unsigned char pos[3], var[3];
+	const char *class;
+	const char *str;
+};
+
+static struct {
+	char *rule;
+	int count;
+/* Whether rules_apply_batch() can run it */
+	int batch;
+	struct rules_op op[RULE_BUFFER_SIZE];
+} rules_prog;
+
+/*
+ * Words being processed by rules_apply_batch(), transposed so that each
+ * character position is a row holding that character of every word.  A
+ * command is then a loop over all of the words for each position, which the
+ * compiler turns into SIMD code.  Only commands that map well onto this are
+ * done in batches: case changes (as long as the conversion tables are plain
+ * ASCII), appends, prepends, truncations and reversal.
+ */
+static struct {
+	unsigned char c[RULE_WORD_SIZE + 4][RULES_BATCH];
+	unsigned char length[RULES_BATCH];
+	unsigned char dead[RULES_BATCH];
+	union {
+		char out[RULES_BATCH][RULE_WORD_SIZE + ARCH_SIZE];
+		ARCH_WORD dummy;
+	} aligned;
+	char last[RULE_WORD_SIZE + ARCH_SIZE];
+} CC_CACHE_ALIGN rules_batch;
+
+static int rules_batch_ascii;
+
+#ifdef _OPENMP
+/*
+ * What each thread of rules_apply_parallel() works with, in place of the
+ * buffers and variables rules_apply() has in rules_data.
+ */
+struct rules_thread {
+	unsigned char vars[0x100];
+	union {
+		char buffers[2][RULE_WORD_SIZE * 2 + CACHE_BANK_SHIFT];
+		ARCH_WORD dummy;
+	} aligned;
+	char memory[RULE_WORD_SIZE];
+};
+
+static struct rules_thread *rules_threads;
+static int rules_thread_count;
+static char (*rules_parallel_out)[RULE_WORD_SIZE + ARCH_SIZE];
+#endif
+
+static char *rules_char_classes[0x100];
+
+static int rules_compile_pos(char **rule, struct rules_op *op, int n)
+{
+	unsigned char c = *(*rule)++;
+
+	op->var[n] = 0;
+	if (c == 'l' || c == 'm' || c == 'p' || (c >= 'a' && c <= 'k')) {
+		op->var[n] = c;
+		return 0;
+	}
+
+	if (!c || (op->pos[n] = rules_vars[c]) == INVALID_LENGTH)
+		return 1;
+
+	return 0;
+}
+
+static int rules_compile_value(char **rule, char *value)
+{
+	if (!(*value = *(*rule)++))
+		return 1;
+
+	return 0;
+}
+
+static int rules_compile_class(char **rule, struct rules_op *op)
+{
+	unsigned char c;
+
+	if ((c = *(*rule)++) == '?') {
+		if (!(op->class = rules_classes[ARCH_INDEX(*(*rule)++)]))
+			return 1;
+		return 0;
+	}
+
+	if (!c)
+		return 1;
+
+	if (!rules_char_classes[c]) {
+		rules_char_classes[c] = mem_calloc_tiny(0x100, MEM_ALIGN_NONE);
+		rules_char_classes[c][c] = 1;
+	}
+	op->class = rules_char_classes[c];
+
+	return 0;
+}
+
+static void rules_compile(char *rule)
+{
+	char *start = rule;
+	struct rules_op *op;
+	int n;
+
+	rules_prog.rule = NULL;
+	if (hc_logic)
+		return;
+
+	rules_prog.count = 0;
+	while (((op = &rules_prog.op[rules_prog.count++])->cmd = *rule++))
+	switch (op->cmd) {
+	case ':':
+	case ' ':
+	case '\t':
+	case 'l':
+	case 'u':
+	case 'c':
+	case 'C':
+	case 't':
+	case 'r':
+	case 'd':
+	case 'f':
+	case 'S':
+	case 'V':
+	case 'P':
+	case 'I':
+	case 'U':
+	case 'k':
+	case 'K':
+	case 'q':
+	case 'E':
+	case 'M':
+	case 'Q':
+	case '4':
+	case '6':
+		break;
+
+	case 'X':
+		for (n = 0; n < 3; n++)
+		if (rules_compile_pos(&rule, op, n))
+			return;
+		break;
+
+	case 'v':
+		if (rules_compile_value(&rule, &op->value[0]) ||
+		    op->value[0] < 'a' || op->value[0] > 'k' ||
+		    rules_compile_pos(&rule, op, 0) ||
+		    rules_compile_pos(&rule, op, 1))
+			return;
+		break;
+
+	case 'p':
+	case 'R':
+	case 'L':
+		op->count = 0;
+		if ((op->cmd == 'p' && *rule >= '1' && *rule <= '9') ||
+		    (op->cmd != 'p' && *rule >= '0' && *rule <= '9')) {
+			op->count = 1;
+			if (rules_compile_pos(&rule, op, 0))
+				return;
+		}
+		break;
+
+	case '_':
+	case '<':
+	case '>':
+	case '\'':
+	case 'T':
+	case 'D':
+	case '+':
+	case '-':
+	case 'z':
+	case 'Z':
+	case '.':
+	case ',':
+	case 'y':
+	case 'Y':
+		if (rules_compile_pos(&rule, op, 0))
+			return;
+		break;
+
+	case 'x':
+	case '*':
+	case 'O':
+		if (rules_compile_pos(&rule, op, 0) ||
+		    rules_compile_pos(&rule, op, 1))
+			return;
+		break;
+
+	case 'i':
+	case 'o':
+		if (rules_compile_pos(&rule, op, 0) ||
+		    rules_compile_value(&rule, &op->value[0]))
+			return;
+		break;
+
+	case '$':
+	case '^':
+		n = 0;
+		do {
+			if (rules_compile_value(&rule, &op->value[n++]))
+				return;
+		} while (n < 3 && *rule == op->cmd && rule++);
+		op->count = n;
+		break;
+
+	case '[':
+	case ']':
+	case '{':
+	case '}':
+		op->count = 1;
+		while (*rule == op->cmd) {
+			rule++;
+			op->count++;
+		}
+		break;
+
+	case 's':
+		if (rules_compile_class(&rule, op) ||
+		    rules_compile_value(&rule, &op->value[0]))
+			return;
+		break;
+
+	case '@':
+	case '!':
+	case '/':
+	case '(':
+	case ')':
+		if (rules_compile_class(&rule, op))
+			return;
+		break;
+
+	case '=':
+	case '%':
+		if (rules_compile_pos(&rule, op, 0) ||
+		    rules_compile_class(&rule, op))
+			return;
+		break;
+
+	case 'A':
+		if (rules_compile_pos(&rule, op, 0) ||
+		    rules_compile_value(&rule, &op->value[0]))
+			return;
+		op->str = rule;
+		while (*rule != op->value[0]) {
+			if (!*rule)
+				return;
+			rule++;
+		}
+		op->count = rule++ - op->str;
+		break;
+
+	default:
+		return;
+	}
+
+	rules_prog.count--;
+	rules_prog.rule = start;
+
+	rules_prog.batch = 1;
+	for (n = 0; n < rules_prog.count; n++)
+	switch (rules_prog.op[n].cmd) {
+	case ':':
+	case ' ':
+	case '\t':
+	case '$':
+	case '^':
+	case '[':
+	case ']':
+	case 'r':
+		break;
+
+	case 'l':
+	case 'u':
+	case 'c':
+	case 'C':
+	case 't':
+		if (!rules_batch_ascii)
+			rules_prog.batch = 0;
+		break;
+
+	case '\'':
+		if (!rules_prog.op[n].var[0])
+			break;
+
+	default:
+		rules_prog.batch = 0;
+	}
+}
+
+#define RUN_POSITION(to, n) { \
+	if (((to) = op->var[n] ? \
+	    vars[op->var[n]] : op->pos[n]) == INVALID_LENGTH) { \
+		return NULL; \
+	} \
+}
+
+#define RUN_CLASS(c) \
+	op->class[ARCH_INDEX(c)]
+
+/*
+ * Runs the compiled rule on the word in "in", with "alt" as the spare buffer
+ * and "memory" as the initial memorized word, like the loop in rules_apply()
+ * does.  The variables and the buffer for "M" are passed in as well, so that
+ * several threads can run the rule at once.  rules_errno is left alone here,
+ * it only matters while the rules are checked, which this isn't used for.
+ */
+static char *rules_run(char *in, char *alt, char *memory, int *length_p,
+	unsigned char *vars, char *memory_buf)
+{
+	struct rules_op *op = rules_prog.op;
+	struct rules_op *end = op + rules_prog.count;
+	int length = *length_p;
+	int a, b, c, pos;
+
+	for (; op < end; op++) {
+		if (length >= RULE_WORD_SIZE)
+			in[length = RULE_WORD_SIZE - 1] = 0;
+
+		switch (op->cmd) {
+		case ':':
+		case ' ':
+		case '\t':
+			break;
+
+		case '_':
+			RUN_POSITION(a, 0)
+			if (length != a)
+				return NULL;
+			break;
+
+		case '<':
+			RUN_POSITION(a, 0)
+			if (length >= a)
+				return NULL;
+			break;
+
+		case '>':
+			RUN_POSITION(a, 0)
+			if (length <= a)
+				return NULL;
+			break;
+
+		case 'l':
+			CONV(conv_tolower)
+			break;
+
+		case 'u':
+			CONV(conv_toupper)
+			break;
+
+		case 'c':
+			pos = 0;
+			if ((in[0] = conv_toupper[ARCH_INDEX(in[0])]))
+			while (in[++pos])
+				in[pos] = conv_tolower[ARCH_INDEX(in[pos])];
+			in[pos] = 0;
+			break;
+
+		case 'C':
+			pos = 0;
+			if ((in[0] = conv_tolower[ARCH_INDEX(in[0])]))
+			while (in[++pos])
+				in[pos] = conv_toupper[ARCH_INDEX(in[pos])];
+			in[pos] = 0;
+			break;
+
+		case 't':
+			CONV(conv_invert)
+			break;
+
+		case 'S':
+			CONV(conv_shift)
+			break;
+
+		case 'V':
+			CONV(conv_vowels)
+			break;
+
+		case 'r':
+			{
+				char *out;
+				GET_OUT
+				*(out += length) = 0;
+				while (*in)
+					*--out = *in++;
+				in = out;
+			}
+			break;
+
+		case 'd':
+			memcpy(in + length, in, length);
+			in[length <<= 1] = 0;
+			break;
+
+		case 'f':
+			{
+				char *p = in;
+				in[pos = (length <<= 1)] = 0;
+				while (*p)
+					in[--pos] = *p++;
+			}
+			break;
+
+		case 'p':
+			if (op->count) {
+				RUN_POSITION(a, 0)
+				b = a;
+				in[length * (a + 1)] = 0;
+				while (a) {
+					memcpy(in + length * a, in, length);
+					--a;
+				}
+				length *= (b + 1);
+				break;
+			}
+			if (length < 2)
+				break;
+			pos = length - 1;
+			if (strchr("sxz", in[pos]) ||
+			    (pos > 1 && in[pos] == 'h' &&
+			    (in[pos - 1] == 'c' || in[pos - 1] == 's')))
+				strcat(in, "es");
+			else
+			if (in[pos] == 'f' && in[pos - 1] != 'f')
+				strcpy(&in[pos], "ves");
+			else
+			if (pos > 1 && in[pos] == 'e' && in[pos - 1] == 'f')
+				strcpy(&in[pos - 1], "ves");
+			else
+			if (pos > 1 && in[pos] == 'y') {
+				if (strchr("aeiou", in[pos - 1]))
+					strcat(in, "s");
+				else
+					strcpy(&in[pos], "ies");
+			} else
+				strcat(in, "s");
+			length = strlen(in);
+			break;
+
+		case '$':
+			in[length++] = op->value[0];
+			if (op->count > 1)
+				in[length++] = op->value[1];
+			if (op->count > 2)
+				in[length++] = op->value[2];
+			in[length] = 0;
+			break;
+
+		case '^':
+			{
+				char *out;
+				GET_OUT
+				if (op->count == 1) {
+					out[0] = op->value[0];
+					memcpy(&out[1], in, ++length);
+				} else if (op->count == 2) {
+					out[0] = op->value[1];
+					out[1] = op->value[0];
+					memcpy(&out[2], in, length + 1);
+					length += 2;
+				} else {
+					out[0] = op->value[2];
+					out[1] = op->value[1];
+					out[2] = op->value[0];
+					memcpy(&out[3], in, length + 1);
+					length += 3;
+				}
+				in = out;
+			}
+			break;
+
+		case 'x':
+			RUN_POSITION(a, 0)
+			RUN_POSITION(b, 1)
+			if (a < length) {
+				char *out;
+				GET_OUT
+				in += a;
+				strnzcpy(out, in, b + 1);
+				length = strlen(in = out);
+				break;
+			}
+			in[length = 0] = 0;
+			break;
+
+		case 'i':
+			RUN_POSITION(a, 0)
+			if (a < length) {
+				char *p = in + a;
+				memmove(p + 1, p, length++ - a);
+				*p = op->value[0];
+				in[length] = 0;
+				break;
+			}
+			in[length++] = op->value[0];
+			in[length] = 0;
+			break;
+
+		case 'o':
+			RUN_POSITION(a, 0)
+			if (a < length)
+				in[a] = op->value[0];
+			break;
+
+		case 's':
+			for (pos = 0; ARCH_INDEX(in[pos]); pos++)
+			if (RUN_CLASS(in[pos]))
+				in[pos] = op->value[0];
+			break;
+
+		case '@':
+			length = 0;
+			for (pos = 0; ARCH_INDEX(in[pos]); pos++)
+			if (!RUN_CLASS(in[pos]))
+				in[length++] = in[pos];
+			in[length] = 0;
+			break;
+
+		case '!':
+			for (pos = 0; ARCH_INDEX(in[pos]); pos++)
+			if (RUN_CLASS(in[pos]))
+				return NULL;
+			break;
+
+		case '/':
+			for (pos = 0; ARCH_INDEX(in[pos]); pos++)
+			if (RUN_CLASS(in[pos]))
+				break;
+			vars['p'] = pos;
+			if (!in[pos])
+				return NULL;
+			break;
+
+		case '=':
+			RUN_POSITION(a, 0)
+			if (a >= length ||
+			    (ARCH_INDEX(in[a]) && !RUN_CLASS(in[a])))
+				return NULL;
+			break;
+
+		case '[':
+			if ((length -= op->count) > 0) {
+				char *out;
+				GET_OUT
+				memcpy(out, &in[op->count], length + 1);
+				in = out;
+				break;
+			}
+			in[length = 0] = 0;
+			break;
+
+		case ']':
+			if ((length -= op->count) < 0)
+				length = 0;
+			in[length] = 0;
+			break;
+
+		case '(':
+			if (ARCH_INDEX(in[0]) && !RUN_CLASS(in[0]))
+				return NULL;
+			break;
+
+		case ')':
+			if (!length || (ARCH_INDEX(in[length - 1]) &&
+			    !RUN_CLASS(in[length - 1])))
+				return NULL;
+			break;
+
+		case '\'':
+			RUN_POSITION(a, 0)
+			if (a < length)
+				in[length = a] = 0;
+			break;
+
+		case '%':
+			RUN_POSITION(a, 0)
+			b = 0;
+			for (pos = 0; ARCH_INDEX(in[pos]); pos++)
+			if (RUN_CLASS(in[pos]) && ++b >= a)
+				break;
+			if (b < a)
+				return NULL;
+			vars['p'] = pos;
+			break;
+
+		case 'A':
+			RUN_POSITION(a, 0)
+			{
+				char *out = in, *p, *start;
+				const char *s = op->str;
+
+				if (a >= length)
+					a = length;
+				else
+					GET_OUT
+				if (out != in)
+					memcpy(out, in, a);
+				start = p = &out[a];
+				for (b = 0; b < op->count; b++)
+				if (p < &out[RULE_WORD_SIZE - 1])
+					*p++ = s[b];
+				if (out == in)
+					*p = 0;
+				else {
+					strcpy(p, &in[a]);
+					in = out;
+				}
+				length += p - start;
+			}
+			break;
+
+		case 'T':
+			RUN_POSITION(a, 0)
+			in[a] = conv_invert[ARCH_INDEX(in[a])];
+			break;
+
+		case 'D':
+			RUN_POSITION(a, 0)
+			if (a < length) {
+				memmove(&in[a], &in[a + 1], length - a);
+				length--;
+			}
+			break;
+
+		case '{':
+			if (length) {
+				char *out;
+				b = op->count;
+				while (b >= length)
+					b -= length;
+				if (!b)
+					break;
+				GET_OUT
+				memcpy(out, &in[b], length - b);
+				memcpy(&out[length - b], in, b);
+				out[length] = 0;
+				in = out;
+				break;
+			}
+			in[0] = 0;
+			break;
+
+		case '}':
+			if (length) {
+				char *out;
+				b = op->count;
+				while (b >= length)
+					b -= length;
+				if (!b)
+					break;
+				GET_OUT
+				memcpy(out, &in[pos = length - b], b);
+				memcpy(&out[b], in, pos);
+				out[length] = 0;
+				in = out;
+				break;
+			}
+			in[0] = 0;
+			break;
+
+		case 'R':
+			if (op->count) {
+				RUN_POSITION(a, 0)
+				if (a < length)
+					in[a] = (unsigned char)in[a] >> 1;
+				break;
+			}
+			CONV(conv_right)
+			break;
+
+		case 'L':
+			if (op->count) {
+				RUN_POSITION(a, 0)
+				if (a < length)
+					in[a] = (unsigned char)in[a] << 1;
+				break;
+			}
+			CONV(conv_left)
+			break;
+
+		case 'P':
+			if ((pos = length - 1) < 2)
+				break;
+			if (in[pos] == 'd' && in[pos - 1] == 'e')
+				break;
+			if (in[pos] == 'y') in[pos] = 'i'; else
+			if (strchr("bgp", in[pos]) &&
+			    !strchr("bgp", in[pos - 1])) {
+				in[pos + 1] = in[pos];
+				in[pos + 2] = 0;
+			}
+			if (in[pos] == 'e')
+				strcat(in, "d");
+			else
+				strcat(in, "ed");
+			length = strlen(in);
+			break;
+
+		case 'I':
+			if ((pos = length - 1) < 2)
+				break;
+			if (in[pos] == 'g' && in[pos - 1] == 'n' &&
+			    in[pos - 2] == 'i')
+				break;
+			if (strchr("aeiou", in[pos]))
+				strcpy(&in[pos], "ing");
+			else {
+				if (strchr("bgp", in[pos]) &&
+				    !strchr("bgp", in[pos - 1])) {
+					in[pos + 1] = in[pos];
+					in[pos + 2] = 0;
+				}
+				strcat(in, "ing");
+			}
+			length = strlen(in);
+			break;
+
+		case 'U':
+			if (!valid_utf8((UTF8*)in))
+				return NULL;
+			break;
+
+		case '+':
+			RUN_POSITION(a, 0)
+			if (a < length)
+				++in[a];
+			break;
+
+		case '-':
+			RUN_POSITION(a, 0)
+			if (a < length)
+				--in[a];
+			break;
+
+		case 'k':
+			if (length > 1)
+				SWAP2(0, 1)
+			break;
+
+		case 'K':
+			if (length > 1)
+				SWAP2((unsigned)length - 1, (unsigned)length - 2)
+			break;
+
+		case '*':
+			RUN_POSITION(a, 0)
+			RUN_POSITION(b, 1)
+			if (length > a && length > b)
+				SWAP2(a, b)
+			break;
+
+		case 'z':
+			RUN_POSITION(a, 0)
+			b = length;
+			while (b) {
+				in[b + a] = in[b];
+				--b;
+			}
+			length += a;
+			in[length] = 0;
+			while (a) {
+				in[a] = in[0];
+				--a;
+			}
+			break;
+
+		case 'Z':
+			RUN_POSITION(a, 0)
+			while (a) {
+				in[length] = in[length - 1];
+				++length;
+				--a;
+			}
+			in[length] = 0;
+			break;
+
+		case 'q':
+			b = length << 1;
+			in[b--] = 0;
+			while (b > 0) {
+				in[b] = in[b - 1] = in[b >> 1];
+				b -= 2;
+			}
+			length <<= 1;
+			break;
+
+		case '.':
+			RUN_POSITION(a, 0)
+			if (a < length - 1 && length > 1)
+				in[a] = in[a + 1];
+			break;
+
+		case ',':
+			RUN_POSITION(a, 0)
+			if (a >= 1 && length > 1 && a < length)
+				in[a] = in[a - 1];
+			break;
+
+		case 'y':
+			RUN_POSITION(a, 0)
+			if (a <= length) {
+				memmove(&in[a], in, length);
+				length += a;
+				in[length] = 0;
+			}
+			break;
+
+		case 'Y':
+			RUN_POSITION(a, 0)
+			if (a <= length) {
+				memmove(&in[length], &in[length - a], a);
+				length += a;
+				in[length] = 0;
+			}
+			break;
+
+		case 'O':
+			RUN_POSITION(a, 0)
+			RUN_POSITION(b, 1)
+			if (a < length && a + b <= length) {
+				char *out;
+				GET_OUT
+				strncpy(out, in, a);
+				in += a + b;
+				strnzcpy(out + a, in, length - (a + b) + 1);
+				length -= b;
+				in = out;
+			}
+			break;
+
+		case 'M':
+			memory = memory_buf;
+			strnfcpy(memory_buf, in, rules_max_length);
+			vars['m'] = (unsigned char)length - 1;
+			break;
+
+		case 'Q':
+			if (!strncmp(memory, in, rules_max_length))
+				return NULL;
+			break;
+
+		case 'X':
+			RUN_POSITION(a, 0)
+			RUN_POSITION(b, 1)
+			RUN_POSITION(c, 2)
+			{
+				int mleft = (int)(unsigned char)
+				    (vars['m'] + 1) - a;
+				char *inp;
+
+				if (b > mleft)
+					b = mleft;
+				if (b <= 0)
+					break;
+				if (c >= length) {
+					memcpy(&in[length], memory + a, b);
+					in[length += b] = 0;
+					break;
+				}
+				inp = in + c;
+				memmove(inp + b, inp, length - c);
+				in[length += b] = 0;
+				memcpy(inp, memory + a, b);
+			}
+			break;
+
+		case 'v':
+			vars['l'] = length;
+			RUN_POSITION(a, 0)
+			RUN_POSITION(b, 1)
+			vars[ARCH_INDEX(op->value[0])] = a - b;
+			break;
+
+		case '4':
+			c = vars['m'] + 1;
+			memcpy(&in[length], memory, c);
+			in[length += c] = 0;
+			break;
+
+		case '6':
+			c = vars['m'] + 1;
+			memmove(&in[c], in, length);
+			memcpy(in, memory, c);
+			in[length += c] = 0;
+			break;
+
+		case 'E':
+			{
+				int up = 1;
+				for (pos = 0; in[pos]; pos++)
+				if (up) {
+					if (in[pos] != ' ') {
+						if (in[pos] >= 'a' && in[pos] <= 'z')
+							in[pos] -= 0x20;
+						up = 0;
+					}
+				} else {
+					if (in[pos] == ' ')
+						up = 1;
+					else if (in[pos] >= 'A' && in[pos] <= 'Z')
+						in[pos] += 0x20;
+				}
+			}
+			break;
+		}
+
+		if (!length)
+			return NULL;
+	}
+
+	*length_p = length;
+	return in;
+}
+
 void rules_init(int max_length)
 {
 	rules_pass = 0;
 	rules_errno = RULES_ERROR_NONE;
 	hc_logic = 0;
+	rules_prog.rule = NULL;
 
 	if (max_length > RULE_WORD_SIZE - 1)
 		max_length = RULE_WORD_SIZE - 1;
@@ -1155,8 +2091,21 @@ void rules_init(int max_length)
 	if (max_length == rules_max_length) return;
 
 	if (!rules_max_length) {
+		int c;
+
 		rules_init_classes();
 		rules_init_convs();
+
+		rules_batch_ascii = 1;
+		for (c = 0; c < 0x100; c++) {
+			int lower = (c >= 'A' && c <= 'Z') ? c + 0x20 : c;
+			int upper = (c >= 'a' && c <= 'z') ? c - 0x20 : c;
+
+			if (ARCH_INDEX(conv_tolower[c]) != lower ||
+			    ARCH_INDEX(conv_toupper[c]) != upper ||
+			    ARCH_INDEX(conv_invert[c]) != lower + upper - c)
+				rules_batch_ascii = 0;
+		}
 	}
 	rules_init_length(max_length);
 }
@@ -1165,6 +2114,8 @@ char *rules_reject(char *rule, int split, char *last, struct db_main *db)
 {
 	static char out_rule[RULE_BUFFER_SIZE];
 
+	rules_prog.rule = NULL;
+
 	if (hc_logic && !strncmp(rule, "!! hashcat logic", 16))
 		return NULL;
 
@@ -1249,6 +2200,9 @@ accept:
 	rules_apply(safe_null_string, out_rule, split, last);
 	rules_pass++;
 
+	if (!rules_pass && split < 0)
+		rules_compile(out_rule);
+
 	return out_rule;
 }
 
@@ -1298,6 +2252,13 @@ char *rules_apply(char *word_in, char *rule, int split, char *last)
 	rules_vars['l'] = length;
 	rules_vars['m'] = (unsigned char)length - 1;
 
+	if (rule == rules_prog.rule && split < 0 && !hc_logic && !rules_pass) {
+		if (!(in = rules_run(in, alt, memory, &length,
+		    rules_vars, memory_buffer)))
+			return NULL;
+		goto out_OK;
+	}
+
 	which = 0;
 
 	while (RULE) {
@@ -2248,6 +3209,248 @@ out_ERROR_UNALLOWED:
 	goto out_NULL;
 }
 
+int rules_batch_ok(char *rule)
+{
+	return rule == rules_prog.rule && rules_prog.batch &&
+		!hc_logic && !rules_pass &&
+		!(options.internal_cp != UTF_8 && options.target_enc == UTF_8);
+}
+
+#define BATCH_LOOP(first, body) \
+	for (pos = first; pos < rows; pos++) { \
+		unsigned char *row = c[pos]; \
+		for (w = 0; w < RULES_BATCH; w++) { \
+			body; \
+		} \
+	}
+
+#define BATCH_IS_UPPER(x) \
+	((unsigned char)((x) - 'A') < 26)
+#define BATCH_IS_LOWER(x) \
+	((unsigned char)((x) - 'a') < 26)
+
+int rules_apply_batch(char **words, int count, char *rule, char *last,
+	char **out)
+{
+	struct rules_op *op = rules_prog.op;
+	struct rules_op *end = op + rules_prog.count;
+	unsigned char (*c)[RULES_BATCH] = rules_batch.c;
+	unsigned char *length = rules_batch.length;
+	unsigned char *dead = rules_batch.dead;
+	char *prev = NULL;
+	int w, pos, rows, n;
+
+	if (last) {
+		strnzcpy(rules_batch.last, last, sizeof(rules_batch.last));
+		prev = rules_batch.last;
+	}
+
+	rows = 0;
+	for (w = 0; w < RULES_BATCH; w++) {
+		const char *word = w < count ? words[w] : "";
+
+		for (pos = 0; pos < RULE_WORD_SIZE && word[pos]; pos++)
+			c[pos][w] = word[pos];
+		if ((length[w] = pos) > rows)
+			rows = pos;
+/* Same as rules_apply(), with the no-op rule an empty word gets through */
+		dead[w] = !pos && (op < end || w >= count);
+	}
+
+	for (; op < end; op++) {
+		if (rows >= RULE_WORD_SIZE) {
+			rows = RULE_WORD_SIZE - 1;
+			for (w = 0; w < RULES_BATCH; w++)
+			if (length[w] > rows)
+				length[w] = rows;
+		}
+
+		switch (op->cmd) {
+		case 'l':
+			BATCH_LOOP(0, row[w] += BATCH_IS_UPPER(row[w]) << 5)
+			break;
+
+		case 'u':
+			BATCH_LOOP(0, row[w] -= BATCH_IS_LOWER(row[w]) << 5)
+			break;
+
+		case 't':
+			BATCH_LOOP(0,
+			    row[w] ^= BATCH_IS_LOWER(row[w] | 0x20) << 5)
+			break;
+
+		case 'c':
+			for (w = 0; w < RULES_BATCH; w++)
+				c[0][w] -= BATCH_IS_LOWER(c[0][w]) << 5;
+			BATCH_LOOP(1, row[w] += BATCH_IS_UPPER(row[w]) << 5)
+			break;
+
+		case 'C':
+			for (w = 0; w < RULES_BATCH; w++)
+				c[0][w] += BATCH_IS_UPPER(c[0][w]) << 5;
+			BATCH_LOOP(1, row[w] -= BATCH_IS_LOWER(row[w]) << 5)
+			break;
+
+		case '$':
+			for (w = 0; w < RULES_BATCH; w++) {
+				for (n = 0; n < op->count; n++)
+					c[length[w] + n][w] = op->value[n];
+				length[w] += op->count;
+			}
+			rows += op->count;
+			break;
+
+		case '^':
+			for (pos = rows - 1; pos >= 0; pos--)
+				memcpy(c[pos + op->count], c[pos], RULES_BATCH);
+			for (n = 0; n < op->count; n++)
+				memset(c[n], op->value[op->count - 1 - n],
+				    RULES_BATCH);
+			for (w = 0; w < RULES_BATCH; w++)
+				length[w] += op->count;
+			rows += op->count;
+			break;
+
+		case '[':
+			for (pos = 0; pos + op->count < rows; pos++)
+				memcpy(c[pos], c[pos + op->count], RULES_BATCH);
+			for (w = 0; w < RULES_BATCH; w++)
+				length[w] = (length[w] > op->count) ?
+					length[w] - op->count : 0;
+			rows = (rows > op->count) ? rows - op->count : 0;
+			break;
+
+		case ']':
+			for (w = 0; w < RULES_BATCH; w++)
+				length[w] = (length[w] > op->count) ?
+					length[w] - op->count : 0;
+			break;
+
+		case '\'':
+			for (w = 0; w < RULES_BATCH; w++)
+			if (length[w] > op->pos[0])
+				length[w] = op->pos[0];
+			break;
+
+		case 'r':
+			for (w = 0; w < RULES_BATCH; w++)
+			for (pos = 0; pos < length[w] / 2; pos++) {
+				unsigned char tmp = c[pos][w];
+
+				c[pos][w] = c[length[w] - 1 - pos][w];
+				c[length[w] - 1 - pos][w] = tmp;
+			}
+			break;
+		}
+
+		for (w = 0; w < RULES_BATCH; w++)
+			dead[w] |= !length[w];
+	}
+
+	for (w = 0; w < count; w++) {
+		char *word = rules_batch.aligned.out[w];
+
+		out[w] = NULL;
+		if (dead[w])
+			continue;
+		if ((minlength && length[w] < minlength) ||
+		    (maxlength && length[w] > maxlength))
+			continue;
+
+		n = MIN(length[w], rules_max_length);
+		for (pos = 0; pos < n; pos++)
+			word[pos] = c[pos][w];
+		word[n] = 0;
+
+		if (prev && !strcmp(word, prev))
+			continue;
+		out[w] = prev = word;
+	}
+
+	return count;
+}
+
+#ifdef _OPENMP
+int rules_parallel_ok(char *rule)
+{
+	return rule == rules_prog.rule && !hc_logic && !rules_pass &&
+		!(options.internal_cp != UTF_8 && options.target_enc == UTF_8) &&
+		omp_get_max_threads() > 1;
+}
+
+int rules_apply_parallel(char **words, int count, char *rule, char *last,
+	char **out)
+{
+	char prev_buf[RULE_WORD_SIZE + ARCH_SIZE], *prev = NULL;
+	int w, threads = omp_get_max_threads();
+
+/* last may well be one of the words we're about to overwrite */
+	if (last) {
+		strnzcpy(prev_buf, last, sizeof(prev_buf));
+		prev = prev_buf;
+	}
+
+	if (!rules_threads || threads > rules_thread_count) {
+		MEM_FREE(rules_threads);
+		rules_threads = mem_alloc_align(threads *
+		    sizeof(*rules_threads), MEM_ALIGN_CACHE);
+		rules_thread_count = threads;
+	}
+	if (!rules_parallel_out)
+		rules_parallel_out = mem_alloc_align(RULES_OMP_BATCH *
+		    sizeof(*rules_parallel_out), MEM_ALIGN_CACHE);
+
+#pragma omp parallel for schedule(static)
+	for (w = 0; w < count; w++) {
+		struct rules_thread *t = &rules_threads[omp_get_thread_num()];
+		char *word = words[w];
+		char *in = t->aligned.buffers[0];
+		int length;
+
+		out[w] = NULL;
+
+		length = 0;
+		while (length < RULE_WORD_SIZE) {
+			if (!(in[length] = word[length]))
+				break;
+			length++;
+		}
+
+/* Same as rules_apply(), with the no-op rule an empty word gets through */
+		if (*rule) {
+			if (!length)
+				continue;
+			memcpy(t->vars, rules_vars, sizeof(t->vars));
+			t->vars['l'] = length;
+			t->vars['m'] = (unsigned char)length - 1;
+			if (!(in = rules_run(in, t->aligned.buffers[1], word,
+			    &length, t->vars, t->memory)))
+				continue;
+		}
+
+		if ((minlength && length < minlength) ||
+		    (maxlength && length > maxlength))
+			continue;
+
+		in[rules_max_length] = 0;
+		strcpy(rules_parallel_out[w], in);
+		out[w] = rules_parallel_out[w];
+	}
+
+/* Rejecting repeats has to be done in order */
+	for (w = 0; w < count; w++) {
+		if (!out[w])
+			continue;
+		if (prev && !strcmp(out[w], prev))
+			out[w] = NULL;
+		else
+			prev = out[w];
+	}
+
+	return count;
+}
+#endif
+
 /*
  * This function is currently not used outside of rules.c, thus not exported.
  *
@@ -2261,7 +3464,8 @@ static int rules_check(struct rpp_context *start, int split)
 {
 	struct rpp_context ctx;
 	char *rule;
-	int count;
+	int count, checked;
+	unsigned long long left;
 
 	rules_errno = RULES_ERROR_NONE;
 
@@ -2270,12 +3474,23 @@ static int rules_check(struct rpp_context *start, int split)
 	count = 0;
 
 	rules_pass = -1; /* rules_reject() will turn this into -2 */
+	checked = 0;
 	while ((rule = rpp_next(&ctx))) {
 		rules_reject(rule, split, NULL, NULL);
 		if (rules_errno) break;
 
 		if (ctx.input) rules_line = ctx.input->number;
 		count++;
+
+		if (ctx.count < 0) {
+			checked = 0;
+		} else if (++checked >= RULES_CHECK_MAX &&
+		    (left = rpp_line_left(&ctx))) {
+			rpp_skip(&ctx, left);
+			count += left;
+			checked = 0;
+			if (ctx.input) rules_line = ctx.input->number;
+		}
 	}
 	rules_pass = 0;
 
@@ -48,6 +48,39 @@ extern char *rules_reject(char *rule, int split, char *last,
  */
 extern char *rules_apply(char *word, char *rule, int split, char *last);
 
+/*
+ * Returns non-zero if rules_apply_batch() can be used with this rule, which
+ * has to be what rules_reject() has just returned.
+ */
+extern int rules_batch_ok(char *rule);
+
+/*
+ * Applies the rule to count (up to RULES_BATCH) words at once, same as
+ * rules_apply() with split < 0 would for each, with last being the previous
+ * mangled word and then each word not rejected in turn.  Sets out[] to the
+ * mangled words or NULL for those rejected, and returns count.  The mangled
+ * words remain valid until the next call.
+ */
+extern int rules_apply_batch(char **words, int count, char *rule, char *last,
+	char **out);
+
+#ifdef _OPENMP
+/*
+ * Returns non-zero if rules_apply_parallel() can be used with this rule,
+ * which has to be what rules_reject() has just returned, and there's more
+ * than one OpenMP thread to use.
+ */
+extern int rules_parallel_ok(char *rule);
+
+/*
+ * Same as rules_apply_batch(), but for up to RULES_OMP_BATCH words and any
+ * rule rules_parallel_ok() accepts, with the words split between the OpenMP
+ * threads.  The output is in the same order as the words.
+ */
+extern int rules_apply_parallel(char **words, int count, char *rule,
+	char *last, char **out);
+#endif
+
 /*
  * Similar to rules_check(), but displays a message and does not return on
  * error.  Also performs 'dupe' rule removal, and lists if any rules were removed.
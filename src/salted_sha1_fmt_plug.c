@@ -80,7 +80,7 @@ struct s_salt
 };
 
 static struct s_salt *saved_salt;
-
+static struct fmt_main *self;
 
 #ifdef SIMD_COEF_32
 static uint32_t (*saved_key)[SHA_BUF_SIZ*NBKEYS];
@@ -93,12 +93,19 @@ static char (*saved_key)[PLAINTEXT_LENGTH + 1];
 static uint32_t (*crypt_key)[BINARY_SIZE / 4];
 #endif
 
-static void init(struct fmt_main *self)
+static void init(struct fmt_main *_self)
 {
+	self = _self;
 #ifdef _OPENMP
 	int omp_t;
 
 	omp_t = omp_get_max_threads();
+/*
+ * With a single thread there's no thread startup to save, while the outputs
+ * for a block of salts no longer fit in L2, so batching them is a loss.
+ */
+	if (omp_t == 1)
+		self->methods.crypt_all_salts = NULL;
 	self->params.min_keys_per_crypt *= omp_t;
 	omp_t *= OMP_SCALE;
 	self->params.max_keys_per_crypt *= omp_t;
@@ -106,14 +113,15 @@ static void init(struct fmt_main *self)
 #ifndef SIMD_COEF_32
 	saved_key = mem_calloc(self->params.max_keys_per_crypt,
 	                       sizeof(*saved_key));
-	crypt_key = mem_calloc(self->params.max_keys_per_crypt,
-	                       sizeof(*crypt_key));
+	crypt_key = mem_calloc(self->params.max_keys_per_crypt *
+	                       FMT_MAX_SALTS_PER_CRYPT, sizeof(*crypt_key));
 #else
 	saved_len = mem_calloc(self->params.max_keys_per_crypt,
 	                       sizeof(*saved_len));
 	saved_key = mem_calloc_align(self->params.max_keys_per_crypt/NBKEYS,
 	                             sizeof(*saved_key), MEM_ALIGN_SIMD);
-	crypt_key = mem_calloc_align(self->params.max_keys_per_crypt/NBKEYS,
+	crypt_key = mem_calloc_align(self->params.max_keys_per_crypt/NBKEYS *
+	                             FMT_MAX_SALTS_PER_CRYPT,
 	                             sizeof(*crypt_key), MEM_ALIGN_SIMD);
 #endif
 }
@@ -260,19 +268,19 @@ static void set_salt(void *salt) {
 }
 
 #ifdef SIMD_COEF_32
-inline static void set_onesalt(int index)
+inline static void set_onesalt(int index, struct s_salt *salt, int prev_size)
 {
 	unsigned int i, idx=index%NBKEYS;
 	unsigned char *sk = (unsigned char*)&saved_key[index/NBKEYS];
 
-	for (i=0;i<saved_salt->len;++i)
-		sk[GETPOS(i+saved_len[index], idx)] = saved_salt->data.c[i];
+	for (i=0;i<salt->len;++i)
+		sk[GETPOS(i+saved_len[index], idx)] = salt->data.c[i];
 	sk[GETPOS(i+saved_len[index], idx)] = 0x80;
 
-	while (++i <= last_salt_size)
+	while (++i <= prev_size)
 		sk[GETPOS(i+saved_len[index], idx)] = 0;
 
-	((unsigned int*)sk)[15*SIMD_COEF_32 + (index&(SIMD_COEF_32-1)) + idx/SIMD_COEF_32*SHA_BUF_SIZ*SIMD_COEF_32] = (saved_salt->len + saved_len[index])<<3;
+	((unsigned int*)sk)[15*SIMD_COEF_32 + (index&(SIMD_COEF_32-1)) + idx/SIMD_COEF_32*SHA_BUF_SIZ*SIMD_COEF_32] = (salt->len + saved_len[index])<<3;
 }
 #endif
 
@@ -296,7 +304,7 @@ static int crypt_all(int *pcount, struct db_salt *salt)
 		unsigned int i;
 
 		for (i=0;i<NBKEYS;i++)
-			set_onesalt(i+index);
+			set_onesalt(i+index, saved_salt, last_salt_size);
 		SIMDSHA1body(saved_key[index/NBKEYS], crypt_key[index/NBKEYS], NULL, SSEi_MIXED_IN);
 #else
 		SHA_CTX ctx;
@@ -312,6 +320,65 @@ static int crypt_all(int *pcount, struct db_salt *salt)
 	return count;
 }
 
+/*
+ * Same as crypt_all() for several salts, with the outputs for salts[n] at
+ * n * max_keys_per_crypt and up.  Each block of keys is hashed with all of
+ * the salts while it's still in L1.
+ */
+static void crypt_all_salts(int *pcount, struct db_salt **salts,
+	int salt_count, int *matches)
+{
+	const int count = *pcount;
+	const int max_keys = self->params.max_keys_per_crypt;
+	int index = 0;
+	int n;
+
+#ifdef _OPENMP
+#ifdef SIMD_COEF_32
+	int inc = NBKEYS;
+#else
+	int inc = 1;
+#endif
+
+#pragma omp parallel for private(n)
+	for (index=0; index < count; index += inc)
+#endif
+	{
+#ifdef SIMD_COEF_32
+		int prev_size = last_salt_size;
+
+		for (n = 0; n < salt_count; n++) {
+			struct s_salt *salt = salts[n]->salt;
+			unsigned int i;
+
+			for (i=0;i<NBKEYS;i++)
+				set_onesalt(i+index, salt, prev_size);
+			SIMDSHA1body(saved_key[index/NBKEYS],
+			             crypt_key[(n*max_keys+index)/NBKEYS],
+			             NULL, SSEi_MIXED_IN);
+			prev_size = salt->len;
+		}
+#else
+		SHA_CTX ctx, kctx;
+
+		SHA1_Init( &kctx );
+		SHA1_Update( &kctx, (unsigned char *) saved_key[index], strlen( saved_key[index] ) );
+		for (n = 0; n < salt_count; n++) {
+			struct s_salt *salt = salts[n]->salt;
+
+			ctx = kctx;
+			SHA1_Update( &ctx, (unsigned char *) salt->data.c, salt->len);
+			SHA1_Final( (unsigned char *)crypt_key[n*max_keys+index], &ctx);
+		}
+#endif
+	}
+#ifdef SIMD_COEF_32
+	last_salt_size = ((struct s_salt *)salts[salt_count - 1]->salt)->len;
+#endif
+	for (n = 0; n < salt_count; n++)
+		matches[n] = count;
+}
+
 #ifdef SIMD_COEF_32
 #define HASH_OFFSET	(index&(SIMD_COEF_32-1))+(((unsigned int)index%NBKEYS)/SIMD_COEF_32)*SIMD_COEF_32*5
 static int get_hash_0(int index) { return crypt_key[index/NBKEYS][HASH_OFFSET] & PH_MASK_0; }
@@ -394,7 +461,8 @@ struct fmt_main fmt_saltedsha = {
 		},
 		cmp_all,
 		cmp_one,
-		cmp_exact
+		cmp_exact,
+		crypt_all_salts
 	}
 };
 
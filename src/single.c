@@ -52,9 +52,10 @@ static void save_state(FILE *file)
 
 static int restore_rule_number(void)
 {
-	if (rule_ctx)
-	for (rule_number = 0; rule_number < rec_rule; rule_number++)
-	if (!rpp_next(rule_ctx)) return 1;
+	if (rule_ctx) {
+		if (rpp_skip(rule_ctx, rec_rule)) return 1;
+		rule_number = rec_rule;
+	}
 
 	return 0;
 }
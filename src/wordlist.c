@@ -29,6 +29,7 @@
 #endif
 
 #if !AC_BUILT
+#define HAVE_LIBZ 1 /* legacy build has -lz in LDFLAGS */
  #include <string.h>
  #ifndef _MSC_VER
   #include <strings.h>
@@ -57,6 +58,25 @@
 #endif
 
 #include <errno.h>
+#include <math.h>
+#include <fcntl.h>
+
+#if HAVE_PTHREAD
+#include <pthread.h>
+#include <signal.h>
+#if HAVE_LIBZ || HAVE_LIBBZ2
+#define WL_COMPRESSED			1
+#endif
+#endif
+
+#if WL_COMPRESSED
+#if HAVE_LIBZ
+#include <zlib.h>
+#endif
+#if HAVE_LIBBZ2
+#include <bzlib.h>
+#endif
+#endif
 
 #include "arch.h"
 #include "jumbo.h"
@@ -80,6 +100,7 @@
 #include "unicode.h"
 #include "regex.h"
 #include "mask.h"
+#include "workq.h"
 #include "pseudo_intrinsics.h"
 #include "memdbg.h"
 
@@ -111,6 +132,11 @@ static struct rpp_context *rule_ctx;
 
 // used for memory map of file
 static char *mem_map, *map_pos, *map_end, *map_scan_end;
+// where each pass over the memory-mapped file starts (see set_slice())
+static char *map_start;
+static int64_t first_line;
+// offset past which we ask for more of the memory-mapped file to be read in
+static int64_t map_ahead;
 
 // used for file in 'memory buffer' mode (ready to use array)
 static char *word_file_str, **words;
@@ -118,20 +144,135 @@ static int64_t nWordFileLines;
 
 extern int rpp_real_run; /* set to 1 when we really get into wordlist mode */
 
+/*
+ * Word-major rules: a wordlist too large to be loaded is read in blocks into
+ * the same buffer an in-memory wordlist would use, and every rule is applied
+ * to a block before the next one is read.  Saved state is then the block's
+ * file offset along with the rule and line number within the block.
+ */
+static int word_major;
+static int64_t block_pos, block_end, block_file_len, max_block_words;
+
+/*
+ * Optional line index for a memory-mapped wordlist, kept next to it (with
+ * WL_INDEX_SUFFIX appended to its name).  It holds the offset of every
+ * WL_INDEX_STEP'th line as mgetl() counts them, so that we can get to any
+ * line number by reading fewer than WL_INDEX_STEP lines.  With wl_slices,
+ * words are then distributed across nodes as contiguous slices of the file
+ * rather than line by line.
+ */
+#define WL_INDEX_SUFFIX			".idx"
+#define WL_INDEX_MAGIC			"JtRwix1\n"
+#define WL_INDEX_STEP			0x10000
+
+struct wl_index_header {
+	char magic[8];
+/* Size and modification time of the wordlist indexed */
+	uint64_t size, mtime;
+/* Number of lines, followed by lines / WL_INDEX_STEP + 1 offsets */
+	uint64_t lines;
+	uint64_t step;
+};
+
+static uint64_t *wl_index, wl_index_lines;
+static int wl_slices;
+
+/*
+ * Dupe suppression for a wordlist that isn't loaded (see dupe_seen()).
+ */
+static uint64_t *dupe_filter;
+static size_t dupe_filter_size;
+static uint64_t dupe_blocks_mask;
+static unsigned int dupe_k;
+static int dupe_truncate, dupe_minlength, dupe_maxlength;
+
+static void dupe_skipped(char *line);
+
+/*
+ * A gzip or bzip2 compressed wordlist is decompressed by a thread of its own
+ * into a pipe, which we read from just like from an uncompressed wordlist
+ * that can't be memory-mapped or seeked in.  Each pass over it restarts the
+ * decompression, restoring a session reads up to the saved line number, and
+ * progress is reported as the position within the compressed file.
+ */
+#if WL_COMPRESSED
+#define ZWL_GZIP			1
+#define ZWL_BZIP2			2
+#define ZWL_BUFFER_SIZE			0x40000
+
+static struct {
+	int type;
+/* The compressed file, read by the thread, and its size */
+	FILE *file;
+	int64_t size;
+/* Newlines in the decompressed data, if counted (see zwl_count()) */
+	int64_t lines;
+/* Write end of the pipe */
+	int fd;
+/* Compressed bytes read so far */
+	volatile int64_t pos;
+	volatile int error;
+	int warned;
+	pthread_t thread;
+	unsigned char *in, *out;
+} zwl;
+
+#define wl_compressed			zwl.type
+#else
+#define wl_compressed			0
+#endif
+
+/*
+ * Dynamic work distribution for --fork (see workq.h).  Each rule's pass over
+ * the wordlist is split in wq_parts chunks, by line number for an in-memory
+ * wordlist or by byte offset for a memory-mapped one.  wq_end is where the
+ * current chunk ends, in the same unit.
+ */
+static unsigned int wq_parts;
+static int wq_resumed;
+static uint64_t wq_chunk;
+static int64_t wq_end;
+static struct rpp_context wq_rule_start;
+
 static void save_state(FILE *file)
 {
 	fprintf(file, "%d\n" LLd "\n" LLd "\n",
 	        rec_rule, (long long)rec_pos, (long long)rec_line);
+	if (word_major)
+		fprintf(file, "wlb-v1\n");
+	if (wl_index && wl_slices)
+		fprintf(file, "wli-v1\n");
+}
+
+/*
+ * Whether to use word-major rules and slices of an indexed wordlist is
+ * decided by the session being restored, regardless of what john.conf says
+ * now.
+ */
+static void scan_state(FILE *file)
+{
+	char buf[128];
+
+	word_major = wl_slices = 0;
+	fgetl(buf, sizeof(buf), file);
+	while (!feof(file)) {
+		if (!strcmp(buf, "wlb-v1"))
+			word_major = 1;
+		else if (!strcmp(buf, "wli-v1"))
+			wl_slices = 1;
+		fgetl(buf, sizeof(buf), file);
+	}
 }
 
 static int restore_rule_number(void)
 {
-	if (rule_ctx)
-	for (rule_number = 0; rule_number < rec_rule; rule_number++)
-	if (!rpp_next(rule_ctx)) {
-		fprintf(stderr, "Restored rule number is out of range - "
-		    "has the configuration file changed?\n");
-		return 1;
+	if (rule_ctx) {
+		if (rpp_skip(rule_ctx, rec_rule)) {
+			fprintf(stderr, "Restored rule number is out of range - "
+			    "has the configuration file changed?\n");
+			return 1;
+		}
+		rule_number = rec_rule;
 	}
 
 	return 0;
@@ -254,6 +395,29 @@ static MAYBE_INLINE char *mgetl(char *res)
 	return res;
 }
 
+/*
+ * Has the kernel start reading the memory-mapped file in up to
+ * WORDLIST_READ_AHEAD bytes past the current window, whenever we get to a new
+ * one (or jump back to an earlier one), so that we don't wait for the disk
+ * one page fault at a time.
+ */
+static MAYBE_INLINE void map_read_ahead(void)
+{
+#ifdef MADV_WILLNEED
+	int64_t pos = map_pos - mem_map;
+
+	if (pos < map_ahead && pos + WORDLIST_READ_AHEAD >= map_ahead)
+		return;
+
+	pos &= ~(int64_t)(WORDLIST_READ_AHEAD - 1);
+	map_ahead = pos + WORDLIST_READ_AHEAD;
+	if (map_end > mem_map + pos)
+		madvise(mem_map + pos,
+		    MIN(2 * WORDLIST_READ_AHEAD, map_end - (mem_map + pos)),
+		    MADV_WILLNEED);
+#endif
+}
+
 static MAYBE_INLINE int skip_lines(unsigned long n, char *line)
 {
 	if (n) {
@@ -264,12 +428,452 @@ static MAYBE_INLINE int skip_lines(unsigned long n, char *line)
 			if (mem_map ? !mgetl(line) :
 			    !fgetl(line, LINE_BUFFER_SIZE, word_file))
 				return 1;
+			if (dupe_filter)
+				dupe_skipped(line);
 		} while (--n);
 	}
 
 	return 0;
 }
 
+/*
+ * Moves map_pos to the start of the given line, which must be within the
+ * file.
+ */
+static void wl_index_seek(int64_t line)
+{
+	char buf[LINE_BUFFER_SIZE];
+	int64_t n = line % WL_INDEX_STEP;
+
+	map_pos = mem_map + wl_index[line / WL_INDEX_STEP];
+	while (n-- && mgetl(buf))
+		;
+}
+
+static void wl_index_build(void)
+{
+	char buf[LINE_BUFFER_SIZE];
+	size_t size = 0x100;
+	uint64_t n = 0;
+
+	wl_index = mem_alloc(size * sizeof(*wl_index));
+	map_pos = mem_map;
+	while (1) {
+		if (!(n % WL_INDEX_STEP)) {
+			if (n / WL_INDEX_STEP >= size) {
+				size *= 2;
+				wl_index = mem_realloc(wl_index,
+				    size * sizeof(*wl_index));
+			}
+			wl_index[n / WL_INDEX_STEP] = map_pos - mem_map;
+		}
+		if (!mgetl(buf))
+			break;
+		n++;
+	}
+	map_pos = mem_map;
+
+	wl_index_lines = n;
+}
+
+static int wl_index_write(char *name, struct wl_index_header *header)
+{
+	char *tmp_name = mem_alloc(strlen(name) + 1 + 10 + 5);
+	size_t count = header->lines / WL_INDEX_STEP + 1;
+	FILE *file;
+	int error;
+
+	sprintf(tmp_name, "%s.%u.tmp", name, (unsigned int)getpid());
+
+	if (!(file = fopen(tmp_name, "wb"))) {
+		MEM_FREE(tmp_name);
+		return -1;
+	}
+	error = fwrite(header, sizeof(*header), 1, file) != 1 ||
+	    fwrite(wl_index, sizeof(*wl_index), count, file) != count;
+	if (fclose(file))
+		error = 1;
+	if (!error && rename(tmp_name, name))
+		error = 1;
+	if (error)
+		unlink(tmp_name);
+
+	MEM_FREE(tmp_name);
+	return error ? -1 : 0;
+}
+
+/*
+ * Reads the index for the memory-mapped wordlist, or builds it and tries to
+ * save it if it's missing or out of date.
+ */
+static void wl_index_open(char *name)
+{
+	struct wl_index_header header;
+	struct stat st;
+	char *idx_name;
+	FILE *file;
+	size_t count;
+	int valid = 0;
+
+	if (stat(name, &st))
+		return;
+
+	idx_name = mem_alloc(strlen(name) + sizeof(WL_INDEX_SUFFIX));
+	strcpy(idx_name, name);
+	strcat(idx_name, WL_INDEX_SUFFIX);
+
+	if ((file = fopen(idx_name, "rb"))) {
+		valid = fread(&header, sizeof(header), 1, file) == 1 &&
+		    !memcmp(header.magic, WL_INDEX_MAGIC,
+		    sizeof(header.magic)) &&
+		    header.size == (uint64_t)(map_end - mem_map) &&
+		    header.mtime == (uint64_t)st.st_mtime &&
+		    header.step == WL_INDEX_STEP &&
+		    header.lines <= header.size;
+		if (valid) {
+			count = header.lines / WL_INDEX_STEP + 1;
+			wl_index = mem_alloc(count * sizeof(*wl_index));
+			valid = fread(wl_index, sizeof(*wl_index), count,
+			    file) == count &&
+			    wl_index[count - 1] <= header.size;
+			if (valid)
+				wl_index_lines = header.lines;
+			else
+				MEM_FREE(wl_index);
+		}
+		fclose(file);
+	}
+
+	if (!valid) {
+		log_event("- Indexing wordlist lines");
+		wl_index_build();
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, WL_INDEX_MAGIC, sizeof(header.magic));
+		header.size = map_end - mem_map;
+		header.mtime = st.st_mtime;
+		header.lines = wl_index_lines;
+		header.step = WL_INDEX_STEP;
+		if (wl_index_write(idx_name, &header))
+			log_event("- Can't write wordlist index: %s",
+			    strerror(errno));
+	}
+
+	MEM_FREE(idx_name);
+
+	log_event("- Using wordlist index, "LLu" lines",
+	    (unsigned long long)wl_index_lines);
+}
+
+/*
+ * Limits passes over the memory-mapped wordlist to this node's slice of it,
+ * if we can.  Returns non-zero if so, in which case words are not to be
+ * distributed line by line.
+ */
+static int set_slice(int64_t file_len)
+{
+	char *pos = map_pos;
+	char *end;
+
+	if (!wl_index || !wl_slices || !options.node_count)
+		return 0;
+
+	map_end = mem_map + file_len;
+	wl_index_seek(wl_index_lines * options.node_max / options.node_count);
+	end = map_pos;
+	first_line = wl_index_lines * (options.node_min - 1) /
+		options.node_count;
+	wl_index_seek(first_line);
+	map_start = map_pos;
+	map_end = end;
+	map_scan_end = map_end - VSCANSZ;
+	map_pos = pos;
+
+	log_event("- Will process lines "LLd" to "LLd" of "LLu,
+	    (long long)first_line + 1,
+	    (long long)(wl_index_lines * options.node_max /
+	    options.node_count), (unsigned long long)wl_index_lines);
+
+	return 1;
+}
+
+#if WL_COMPRESSED
+static int zwl_detect(FILE *file)
+{
+	unsigned char magic[10];
+	int type = 0;
+
+	if (fread(magic, 1, sizeof(magic), file) == sizeof(magic)) {
+#if HAVE_LIBZ
+		if (magic[0] == 0x1f && magic[1] == 0x8b && magic[2] == 8)
+			type = ZWL_GZIP;
+#endif
+#if HAVE_LIBBZ2
+		if (!memcmp(magic, "BZh", 3) &&
+		    magic[3] >= '1' && magic[3] <= '9' &&
+		    !memcmp(&magic[4], "1AY&SY", 6))
+			type = ZWL_BZIP2;
+#endif
+	}
+
+	if (jtr_fseek64(file, 0, SEEK_SET))
+		pexit(STR_MACRO(jtr_fseek64));
+
+	return type;
+}
+
+static unsigned int zwl_read(void)
+{
+	size_t count = fread(zwl.in, 1, ZWL_BUFFER_SIZE, zwl.file);
+
+	zwl.pos += count;
+
+	return count;
+}
+
+static int zwl_write(unsigned int count)
+{
+	return count && write_loop(zwl.fd, (char *)zwl.out, count) < 0;
+}
+
+/*
+ * These return 0 at the end of the compressed data, 1 on errors in it, or -1
+ * if the reading end of the pipe has been closed.  Concatenated streams (as
+ * written by parallel compressors) are decompressed one after the other.
+ */
+#if HAVE_LIBZ
+static int zwl_gunzip(void)
+{
+	z_stream zs;
+	int ret = Z_OK, status = 0;
+
+	memset(&zs, 0, sizeof(zs));
+	if (inflateInit2(&zs, 15 + 16) != Z_OK)
+		return 1;
+
+	while (1) {
+		if (!zs.avail_in) {
+			if (!(zs.avail_in = zwl_read()))
+				break;
+			zs.next_in = zwl.in;
+		}
+		if (ret == Z_STREAM_END) {
+			inflateReset(&zs);
+			ret = Z_OK;
+		}
+		zs.next_out = zwl.out;
+		zs.avail_out = ZWL_BUFFER_SIZE;
+		ret = inflate(&zs, Z_NO_FLUSH);
+		if (zwl_write(ZWL_BUFFER_SIZE - zs.avail_out)) {
+			status = -1;
+			break;
+		}
+		if (ret != Z_OK && ret != Z_STREAM_END) {
+			status = 1;
+			break;
+		}
+	}
+
+	inflateEnd(&zs);
+	if (!status && ret != Z_STREAM_END)
+		status = 1;
+
+	return status;
+}
+#endif
+
+#if HAVE_LIBBZ2
+static int zwl_bunzip2(void)
+{
+	bz_stream bs;
+	int ret = BZ_OK, status = 0;
+
+	memset(&bs, 0, sizeof(bs));
+	if (BZ2_bzDecompressInit(&bs, 0, 0) != BZ_OK)
+		return 1;
+
+	while (1) {
+		if (!bs.avail_in) {
+			if (!(bs.avail_in = zwl_read()))
+				break;
+			bs.next_in = (char *)zwl.in;
+		}
+		if (ret == BZ_STREAM_END) {
+			char *next_in = bs.next_in;
+			unsigned int avail_in = bs.avail_in;
+
+			BZ2_bzDecompressEnd(&bs);
+			if (BZ2_bzDecompressInit(&bs, 0, 0) != BZ_OK) {
+				status = 1;
+				break;
+			}
+			bs.next_in = next_in;
+			bs.avail_in = avail_in;
+			ret = BZ_OK;
+		}
+		bs.next_out = (char *)zwl.out;
+		bs.avail_out = ZWL_BUFFER_SIZE;
+		ret = BZ2_bzDecompress(&bs);
+		if (zwl_write(ZWL_BUFFER_SIZE - bs.avail_out)) {
+			status = -1;
+			break;
+		}
+		if (ret != BZ_OK && ret != BZ_STREAM_END) {
+			status = 1;
+			break;
+		}
+	}
+
+	BZ2_bzDecompressEnd(&bs);
+	if (!status && ret != BZ_STREAM_END)
+		status = 1;
+
+	return status;
+}
+#endif
+
+static void *zwl_thread(void *arg)
+{
+	int status = 1;
+
+#if HAVE_LIBZ
+	if (zwl.type == ZWL_GZIP)
+		status = zwl_gunzip();
+#endif
+#if HAVE_LIBBZ2
+	if (zwl.type == ZWL_BZIP2)
+		status = zwl_bunzip2();
+#endif
+	if (status > 0 || ferror(zwl.file))
+		zwl.error = 1;
+
+	close(zwl.fd);
+
+	return NULL;
+}
+
+/*
+ * Starts decompressing from the beginning, with word_file reading from it.
+ */
+static void zwl_start(void)
+{
+	int fds[2], error;
+	sigset_t all, old;
+
+	if (jtr_fseek64(zwl.file, 0, SEEK_SET))
+		pexit(STR_MACRO(jtr_fseek64));
+	zwl.pos = 0;
+
+	if (pipe(fds))
+		pexit("pipe");
+	zwl.fd = fds[1];
+	if (!(word_file = fdopen(fds[0], "rb")))
+		pexit("fdopen");
+	setvbuf(word_file, NULL, _IOFBF, WORDLIST_STDIO_BUFFER);
+
+/* Signals are for the main thread to handle */
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &old);
+	error = pthread_create(&zwl.thread, NULL, zwl_thread, NULL);
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+	if (error) {
+		errno = error;
+		pexit("pthread_create");
+	}
+}
+
+/*
+ * Closes word_file, which has the thread quit if it's not done yet.
+ */
+static void zwl_stop(void)
+{
+	if (fclose(word_file))
+		pexit("fclose");
+	word_file = NULL;
+	pthread_join(zwl.thread, NULL);
+
+	if (zwl.error && !zwl.warned++) {
+		if (john_main_process)
+			fprintf(stderr, "Warning: compressed wordlist is "
+			        "corrupt or truncated\n");
+		log_event("- Warning: compressed wordlist is corrupt or "
+		          "truncated");
+	}
+}
+
+static void zwl_open(FILE *file, int type, int64_t size)
+{
+	zwl.type = type;
+	zwl.file = file;
+	zwl.size = size;
+	zwl.lines = 0;
+	zwl.error = zwl.warned = 0;
+	zwl.in = mem_alloc(ZWL_BUFFER_SIZE);
+	zwl.out = mem_alloc(ZWL_BUFFER_SIZE);
+#ifdef POSIX_FADV_SEQUENTIAL
+	posix_fadvise(fileno(file), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+	zwl_start();
+}
+
+static void zwl_close(void)
+{
+	zwl_stop();
+	if (fclose(zwl.file))
+		pexit("fclose");
+	MEM_FREE(zwl.in);
+	MEM_FREE(zwl.out);
+	zwl.type = 0;
+}
+
+/*
+ * Decompresses it all to count the size and newlines, or until the size is
+ * found to be over limit if that's non-zero, then starts over.  Returns the
+ * size counted.
+ */
+static int64_t zwl_count(int64_t limit)
+{
+	char buf[0x10000];
+	int64_t size = 0;
+	size_t count;
+
+	zwl.lines = 0;
+	while ((count = fread(buf, 1, sizeof(buf), word_file))) {
+		char *p = buf;
+
+		size += count;
+		if (limit && size > limit)
+			break;
+		while ((p = memchr(p, '\n', buf + count - p))) {
+			zwl.lines++;
+			p++;
+		}
+	}
+
+	zwl_stop();
+	zwl_start();
+
+	return size;
+}
+#endif
+
+/*
+ * Gets us back to the start of the wordlist file, for another pass over it.
+ */
+static void rewind_word_file(void)
+{
+#if WL_COMPRESSED
+	if (zwl.type) {
+		zwl_stop();
+		zwl_start();
+		return;
+	}
+#endif
+	if (jtr_fseek64(word_file, 0, SEEK_SET))
+		pexit(STR_MACRO(jtr_fseek64));
+}
+
 static void restore_line_number(void)
 {
 	char line[LINE_BUFFER_SIZE];
@@ -304,20 +908,43 @@ static int restore_state(FILE *file)
 	if (word_file == stdin) {
 		restore_line_number();
 	} else
+	if (dupe_filter) {
+		char line[LINE_BUFFER_SIZE];
+
+		if (mem_map)
+			map_pos = mem_map;
+		else
+			rewind_word_file();
+		skip_lines(rec_line, line);
+		line_number = rec_line;
+	} else
+	if (word_major) {
+		if (jtr_fseek64(word_file, rec_pos, SEEK_SET))
+			pexit(STR_MACRO(jtr_fseek64));
+		line_number = rec_line;
+	} else
 	if (!nWordFileLines) {
-		if (mem_map) {
+		if (mem_map && wq_parts) {
+			if (rec_pos > map_end - mem_map)
+				return 1;
+			map_pos = mem_map + rec_pos;
+		} else if (mem_map) {
 			char line[LINE_BUFFER_SIZE];
-			skip_lines(rec_line, line);
+			if (wl_index && rec_line <= wl_index_lines)
+				wl_index_seek(rec_line);
+			else
+				skip_lines(rec_line, line);
 			rec_pos = 0;
 		} else if (rec_line && !rec_pos) {
 			/* from mem_map build does not have rec_pos */
 			int64_t i = rec_line;
 			char line[LINE_BUFFER_SIZE];
-			jtr_fseek64(word_file, 0, SEEK_SET);
+			rewind_word_file();
 			while (i--)
 				if (!fgetl(line, sizeof(line), word_file))
 					pexit(STR_MACRO(jtr_fseek64));
-			rec_pos = jtr_ftell64(word_file);
+			if (!wl_compressed)
+				rec_pos = jtr_ftell64(word_file);
 		} else
 		if (jtr_fseek64(word_file, rec_pos, SEEK_SET))
 			pexit(STR_MACRO(jtr_fseek64));
@@ -355,6 +982,15 @@ static void fix_state(void)
 	if (word_file == stdin)
 		rec_pos = line_number;
 	else
+	if (word_major)
+		rec_pos = block_pos;
+	else
+	if (wq_parts && mem_map && !nWordFileLines)
+		rec_pos = map_pos - mem_map;
+	else
+	if (wl_compressed)
+		rec_pos = 0;
+	else
 	if (!mem_map && !nWordFileLines &&
 	    (rec_pos = jtr_ftell64(word_file)) < 0) {
 #ifdef __DJGPP__
@@ -364,6 +1000,9 @@ static void fix_state(void)
 #endif
 			pexit(STR_MACRO(jtr_ftell64));
 	}
+
+	if (wq_parts)
+		workq_fix_state();
 }
 
 void wordlist_hybrid_fix_state(void)
@@ -374,6 +1013,9 @@ void wordlist_hybrid_fix_state(void)
 	if (word_file == stdin)
 		hybrid_rec_pos = line_number;
 	else
+	if (wl_compressed)
+		hybrid_rec_pos = 0;
+	else
 	if (!mem_map && !nWordFileLines &&
 	    (hybrid_rec_pos = jtr_ftell64(word_file)) < 0) {
 #ifdef __DJGPP__
@@ -398,12 +1040,26 @@ static double get_progress(void)
 	if (!word_file || word_file == stdin)
 		return -1;
 
+	if (word_major) {
+		double done = nWordFileLines ? ((double)rule_number *
+		    nWordFileLines + line_number) /
+		    ((double)rule_count * nWordFileLines) : 0;
+
+		return 100.0 * (block_pos + (block_end - block_pos) * done) /
+		    block_file_len;
+	}
+
 	if (nWordFileLines) {
 		pos = line_number;
 		size = nWordFileLines;
 	} else if (mem_map) {
-		pos = map_pos - mem_map;
-		size = map_end - mem_map;
+		pos = map_pos - map_start;
+		size = map_end - map_start;
+#if WL_COMPRESSED
+	} else if (zwl.type) {
+		pos = zwl.pos;
+		size = zwl.size;
+#endif
 	} else {
 		pos = jtr_ftell64(word_file);
 		jtr_fseek64(word_file, 0, SEEK_END);
@@ -429,6 +1085,66 @@ static double get_progress(void)
 	        (rule_count * size * mask_mult));
 }
 
+/*
+ * Gets us a chunk to work on, moves to its rule and seeks to its start,
+ * unless we're resuming it.  Returns 0 when ready or 1 if there's no more
+ * work.
+ */
+static int wq_next_chunk(void)
+{
+	int64_t size, per, start;
+	int target;
+
+	while (1) {
+		wq_chunk = workq_next(&wq_resumed);
+
+		if (wq_chunk / wq_parts >= rule_count)
+			return 1;
+		target = wq_chunk / wq_parts;
+
+		size = nWordFileLines ? nWordFileLines : map_end - mem_map;
+		per = (size + wq_parts - 1) / wq_parts;
+		start = MIN(size, per * (int64_t)(wq_chunk % wq_parts));
+		wq_end = MIN(size, start + per);
+		if (start < wq_end)
+			break;
+		workq_skip();
+	}
+
+/*
+ * Chunks come in increasing order, except for right after a restore where we
+ * may need to go back from the rule our own crash recovery file was at.
+ */
+	if (rule_ctx && target != rule_number) {
+		if (target < rule_number) {
+			*rule_ctx = wq_rule_start;
+			rpp_next(rule_ctx);
+			rule_number = 0;
+		}
+		if (rpp_skip(rule_ctx, target - rule_number - 1) ||
+		    !rpp_next(rule_ctx))
+			return 1;
+		rule_number = target;
+		wq_resumed = 0;
+	}
+
+	if (wq_resumed)
+		return 0;
+
+	if (nWordFileLines) {
+		line_number = start;
+	} else {
+		map_pos = mem_map + start;
+/* A line belongs to the chunk its first byte is in */
+		if (start && map_pos[-1] != '\n') {
+			char *p = memchr(map_pos, '\n', map_end - map_pos);
+			map_pos = p ? p + 1 : map_end;
+		}
+	}
+
+	return 0;
+}
+
 static char *dummy_rules_apply(char *word, char *rule, int split, char *last)
 {
 	return word;
@@ -447,24 +1163,67 @@ static MAYBE_INLINE void clean_bom(char *line)
 }
 
 /*
- * This function does two separate things (either or both) just to confuse you.
- * 1. In case we're in loopback mode, skip ciphertext and field separator.
- * 2. Convert to target encoding, if applicable.
- *
- * It does both within the existing buffer - i.e. "right aligned" to the
- * original EOL (the end result is guaranteed to fit).
+ * Words of an in-memory wordlist mangled in a batch by rules_apply_batch(),
+ * or by rules_apply_parallel() if batch_rules is BATCH_OMP, and the line
+ * numbers to continue from after each.
  */
-static MAYBE_INLINE char *convert(char *line)
+#define BATCH_SIMD			1
+#define BATCH_OMP			2
+#if defined(_OPENMP) && RULES_OMP_BATCH > RULES_BATCH
+#define BATCH_MAX			RULES_OMP_BATCH
+#else
+#define BATCH_MAX			RULES_BATCH
+#endif
+
+static int batch_rules, batch_count, batch_pos;
+static char *batch_out[BATCH_MAX];
+static int64_t batch_line[BATCH_MAX];
+
+/*
+ * Mangles the next batch of words up to line end, skipping other nodes'
+ * words if asked to.  Returns the number of words in the batch.
+ */
+static int apply_batch(char *rule, char *last, int64_t end, int skip)
 {
-	char *p;
+	char *in[BATCH_MAX];
+	int count = 0, max = RULES_BATCH;
 
-	if (options.flags & FLG_LOOPBACK_CHK) {
-		if ((p = strchr(line, options.loader.field_sep_char)))
-			line = p + 1;
-		else
-			line += strlen(line);
+#ifdef _OPENMP
+	if (batch_rules == BATCH_OMP)
+		max = RULES_OMP_BATCH;
+#endif
+
+	while (count < max && line_number < end) {
+		if (skip) {
+			int for_node = line_number % options.node_count + 1;
+
+			if (for_node < options.node_min ||
+			    for_node > options.node_max) {
+				line_number++;
+				continue;
+			}
+		}
+		clean_bom(words[line_number]);
+		in[count] = words[line_number++];
+		batch_line[count++] = line_number;
 	}
 
+	if (!count)
+		return 0;
+
+#ifdef _OPENMP
+	if (batch_rules == BATCH_OMP)
+		return rules_apply_parallel(in, count, rule, last, batch_out);
+#endif
+	return rules_apply_batch(in, count, rule, last, batch_out);
+}
+
+/*
+ * Converts a line to the target encoding, if applicable, within the existing
+ * buffer - "right aligned" to the original EOL.
+ */
+static MAYBE_INLINE char *recode(char *line)
+{
 	if (options.input_enc != options.target_enc) {
 		UTF16 u16[LINE_BUFFER_SIZE + 1];
 		char *cp, *s, *d;
@@ -486,6 +1245,114 @@ static MAYBE_INLINE char *convert(char *line)
 	return line;
 }
 
+/*
+ * This function does two separate things (either or both) just to confuse you.
+ * 1. In case we're in loopback mode, skip ciphertext and field separator.
+ * 2. Convert to target encoding, if applicable.
+ *
+ * It does both within the existing buffer - i.e. "right aligned" to the
+ * original EOL (the end result is guaranteed to fit).
+ */
+static MAYBE_INLINE char *convert(char *line)
+{
+	char *p;
+
+	if (options.flags & FLG_LOOPBACK_CHK) {
+		if ((p = strchr(line, options.loader.field_sep_char)))
+			line = p + 1;
+		else
+			line += strlen(line);
+	}
+
+	return recode(line);
+}
+
+/*
+ * Loopback mode's words, when they're taken from the plaintexts the loader
+ * kept (db->loopback) rather than from the pot file itself: the list, its
+ * last entry already in words[], and how many words[] has room for.
+ */
+static struct list_main *loop_list;
+static struct list_entry *loop_last;
+static int64_t loop_words_size;
+
+/*
+ * Appends the plaintexts added to loop_list since we last looked to words[],
+ * filtered like the lines of a wordlist loaded into memory are.  Those added
+ * meanwhile were cracked during this session, so each rule gets to try them.
+ */
+static void loopback_update(int rules, int length, int minlength,
+	int maxlength)
+{
+	struct list_entry *entry;
+	char line[LINE_BUFFER_SIZE + 1], *cp;
+	int len;
+
+	entry = loop_last ? loop_last->next : loop_list->head;
+	for (; entry; entry = entry->next) {
+		loop_last = entry;
+
+		strnzcpy(line, entry->data, LINE_BUFFER_SIZE);
+		cp = recode(line);
+		if (!strncmp(cp, "#!comment", 9))
+			continue;
+		if (!rules) {
+			len = strlen(cp);
+			if ((minlength && len < minlength) ||
+			    (maxlength && len > maxlength))
+				continue;
+			if (len >= length)
+				cp[length] = 0;
+		}
+		if (nWordFileLines && !strcmp(cp, words[nWordFileLines - 1]))
+			continue;
+
+		if (nWordFileLines + 1 >= loop_words_size) {
+			loop_words_size = loop_words_size ?
+				loop_words_size * 2 : 0x1000;
+			words = mem_realloc(words,
+			    loop_words_size * sizeof(char*));
+		}
+		words[nWordFileLines++] = str_alloc_copy(cp);
+	}
+}
+
+/*
+ * Reads the next block of a word-major wordlist into words[], returning the
+ * number of lines read (zero at end of file).  Just like for a wordlist
+ * loaded in one go, line numbers then index that array.
+ */
+static int64_t read_block(void)
+{
+	char *cp = word_file_str;
+	char *ep = cp + options.max_wordfile_memory - (LINE_BUFFER_SIZE + 1);
+	int64_t count = 0;
+
+	if ((block_pos = jtr_ftell64(word_file)) < 0)
+		pexit(STR_MACRO(jtr_ftell64));
+
+	while (count < max_block_words && cp <= ep &&
+	       fgetl(cp, LINE_BUFFER_SIZE, word_file)) {
+		int len = strlen(cp);
+
+		if (!strncmp(cp, "#!comment", 9))
+			continue;
+		words[count++] = convert(cp);
+		cp += len + 1;
+	}
+	if (ferror(word_file))
+		pexit("fgets");
+
+	if ((block_end = jtr_ftell64(word_file)) < 0)
+		pexit(STR_MACRO(jtr_ftell64));
+
+	if (count && options.verbosity == VERB_MAX)
+		log_event("- Read block of "LLd" lines at offset "LLd,
+		          (long long)count, (long long)block_pos);
+
+	return count;
+}
+
 static unsigned int hash_log, hash_size, hash_mask;
 #define ENTRY_END_HASH	0xFFFFFFFF
 #define ENTRY_END_LIST	0xFFFFFFFE
@@ -566,6 +1433,303 @@ static MAYBE_INLINE int wbuf_unique(char *line)
 	return 1;
 }
 
+/*
+ * For a wordlist too large to be loaded, dupe suppression uses a blocked
+ * Bloom filter of the lines seen so far in the current pass over the
+ * wordlist, cleared for each pass.  Each line's bits are all within one
+ * 512-bit block, so a lookup touches a single cache line.  A unique line may
+ * be taken for a duplicate with a small probability, but never the other way
+ * around.  Lines skipped for other nodes are added too, so that all nodes
+ * agree on what's a duplicate, and so are the lines skipped to get back to
+ * where a restored session was.
+ *
+ * Returns non-zero if the line was (probably) seen before, and adds it.
+ */
+static int dupe_seen(const char *line)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL, *block;
+	uint32_t h1, h2;
+	unsigned int i;
+	int seen = 1;
+
+	while (*line) {
+		hash ^= (unsigned char)*line++;
+		hash *= 0x100000001b3ULL;
+	}
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+
+	block = &dupe_filter[(hash & dupe_blocks_mask) * 8];
+	hash ^= hash >> 29;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 32;
+	h1 = hash >> 32;
+	h2 = (uint32_t)hash | 1;
+
+	for (i = 0; i < dupe_k; i++) {
+		unsigned int bit = (h1 + i * h2) & 511;
+		uint64_t mask = 1ULL << (bit & 63);
+
+		if (!(block[bit >> 6] & mask)) {
+			block[bit >> 6] |= mask;
+			seen = 0;
+		}
+	}
+
+	return seen;
+}
+
+/*
+ * Adds a line we're not going to process, as read from the wordlist.
+ */
+static void dupe_skipped(char *line)
+{
+	if (!strncmp(line, "#!comment", 9))
+		return;
+
+	if (options.input_enc != options.target_enc)
+		line = convert(line);
+	if (dupe_truncate) {
+		int len = strlen(line);
+
+		if (len < dupe_minlength ||
+		    (dupe_maxlength && len > dupe_maxlength))
+			return;
+		if (len > dupe_truncate)
+			line[dupe_truncate] = 0;
+	}
+
+	dupe_seen(line);
+}
+
+/*
+ * Sets up the filter for lines lines, with about ppm false positives per
+ * million unique lines.
+ */
+static void dupe_init(uint64_t lines, int ppm)
+{
+	double ln2 = log(2.0);
+	double bits = -log((double)ppm / 1000000) / (ln2 * ln2);
+	uint64_t blocks = 1;
+
+/* Some extra for the blocks not being evenly filled */
+	bits *= 1.2;
+	dupe_k = bits * ln2 + 0.5;
+	if (dupe_k < 1)
+		dupe_k = 1;
+	if (dupe_k > 16)
+		dupe_k = 16;
+
+	while (blocks * 512 < lines * bits)
+		blocks <<= 1;
+	dupe_blocks_mask = blocks - 1;
+	dupe_filter_size = blocks * 64;
+	dupe_filter = mem_calloc_align(dupe_filter_size, 1, 64);
+
+	log_event("- Dupe suppression filter: "Zu" MB for about "LLu
+	          " lines, %u ppm false positives",
+	          dupe_filter_size >> 20, (unsigned long long)lines, ppm);
+}
+
+#if HAVE_PTHREAD
+/*
+ * Optional pipelining of an in-memory wordlist pass (RulesPipeline = Y).  A
+ * second thread applies the current rule to the words ahead of us, filling
+ * one block of candidates while we feed the other one to the cracker, which
+ * meanwhile has the format hash what we've given it so far.
+ *
+ * Along with each candidate the thread stores the line number right after the
+ * word it came from, and line_number is only ever set from those as the
+ * candidates are actually processed.  So fix_state() and the status line see
+ * exactly what they would without the pipeline, no matter how far ahead the
+ * thread is.  Only this thread calls rules_apply() while the pass is going
+ * on, so its static buffers need no locking.
+ *
+ * Not used along with hybrid modes or an external filter, which have their
+ * own per-word work to do.
+ */
+struct pipeline_block {
+	int64_t line[WORDLIST_PIPE_KEYS];
+	char data[WORDLIST_PIPE_SIZE];
+	unsigned int count;
+	int full, done;
+};
+
+static struct {
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	struct pipeline_block *block;
+	int64_t pos, end;
+	char *rule, *last;
+	int skip_lines, quit;
+} pipeline;
+
+static void pipeline_fill(struct pipeline_block *b)
+{
+#if !ARCH_ALLOWS_UNALIGNED
+	char line[LINE_BUFFER_SIZE];
+#endif
+	char *word;
+	unsigned int used = 0;
+
+	b->count = 0;
+	while (pipeline.pos < pipeline.end) {
+		if (b->count >= WORDLIST_PIPE_KEYS ||
+		    used > WORDLIST_PIPE_SIZE - 2 * RULE_WORD_SIZE - 1)
+			return;
+
+		if (pipeline.skip_lines) {
+			int for_node = pipeline.pos % options.node_count + 1;
+
+			if (for_node < options.node_min ||
+			    for_node > options.node_max) {
+				pipeline.pos++;
+				continue;
+			}
+		}
+#if ARCH_ALLOWS_UNALIGNED
+		word = rules_apply(words[pipeline.pos++], pipeline.rule, -1,
+		    pipeline.last);
+#else
+		strcpy(line, words[pipeline.pos++]);
+		word = rules_apply(line, pipeline.rule, -1, pipeline.last);
+#endif
+		if (word) {
+			int len = strlen(word) + 1;
+
+			pipeline.last = word;
+			memcpy(&b->data[used], word, len);
+			used += len;
+			b->line[b->count++] = pipeline.pos;
+		}
+	}
+
+	b->done = 1;
+}
+
+static void *pipeline_thread(void *arg)
+{
+	struct pipeline_block *b;
+	int n = 0;
+
+	pthread_mutex_lock(&pipeline.mutex);
+	while (!pipeline.quit) {
+		b = &pipeline.block[n];
+		if (b->full) {
+			pthread_cond_wait(&pipeline.cond, &pipeline.mutex);
+			continue;
+		}
+		pthread_mutex_unlock(&pipeline.mutex);
+
+		pipeline_fill(b);
+
+		pthread_mutex_lock(&pipeline.mutex);
+		b->full = 1;
+		pthread_cond_broadcast(&pipeline.cond);
+		if (b->done)
+			break;
+		n ^= 1;
+	}
+	pthread_mutex_unlock(&pipeline.mutex);
+
+	return NULL;
+}
+
+/*
+ * Processes the in-memory wordlist from line_number up to end with the rule,
+ * like the plain loop in do_wordlist_crack() does.  Returns -1 if the thread
+ * couldn't be started (so the caller should do it the usual way), 1 if the
+ * cracker says we're done, or 0 once the range is complete.
+ */
+static int pipeline_process(char *rule, char **last, int64_t end,
+	int skip_lines)
+{
+	sigset_t all, old;
+	struct pipeline_block *b;
+	int n = 0, error, retval = 0;
+
+	if (!pipeline.block)
+		pipeline.block = mem_alloc_tiny(2 * sizeof(*pipeline.block),
+		    MEM_ALIGN_CACHE);
+	pipeline.block[0].full = pipeline.block[1].full = 0;
+	pipeline.block[0].done = pipeline.block[1].done = 0;
+
+/* clean_bom() looks at line_number, so it's for us to call */
+	clean_bom(words[line_number]);
+
+	pipeline.pos = line_number;
+	pipeline.end = end;
+	pipeline.rule = rule;
+	pipeline.last = *last;
+	pipeline.skip_lines = skip_lines;
+	pipeline.quit = 0;
+
+	if (pthread_mutex_init(&pipeline.mutex, NULL))
+		return -1;
+	if (pthread_cond_init(&pipeline.cond, NULL)) {
+		pthread_mutex_destroy(&pipeline.mutex);
+		return -1;
+	}
+
+/* Signals are for the main thread to handle */
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &old);
+	error = pthread_create(&pipeline.thread, NULL, pipeline_thread, NULL);
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+	if (error) {
+		pthread_cond_destroy(&pipeline.cond);
+		pthread_mutex_destroy(&pipeline.mutex);
+		return -1;
+	}
+
+	do {
+		unsigned int i;
+		char *key;
+
+		b = &pipeline.block[n];
+		pthread_mutex_lock(&pipeline.mutex);
+		while (!b->full)
+			pthread_cond_wait(&pipeline.cond, &pipeline.mutex);
+		pthread_mutex_unlock(&pipeline.mutex);
+
+		key = b->data;
+		for (i = 0; i < b->count; i++) {
+			line_number = b->line[i];
+			if (crk_process_key(key)) {
+				retval = 1;
+				break;
+			}
+			key += strlen(key) + 1;
+		}
+
+		pthread_mutex_lock(&pipeline.mutex);
+		b->full = 0;
+		pthread_cond_broadcast(&pipeline.cond);
+		pthread_mutex_unlock(&pipeline.mutex);
+		n ^= 1;
+	} while (!retval && !b->done);
+
+	pthread_mutex_lock(&pipeline.mutex);
+	pipeline.quit = 1;
+	pthread_cond_broadcast(&pipeline.cond);
+	pthread_mutex_unlock(&pipeline.mutex);
+
+	pthread_join(pipeline.thread, NULL);
+	pthread_cond_destroy(&pipeline.cond);
+	pthread_mutex_destroy(&pipeline.mutex);
+
+	if (!retval) {
+		line_number = end;
+		*last = pipeline.last;
+	}
+
+	return retval;
+}
+#endif
+
 void do_wordlist_crack(struct db_main *db, char *name, int rules)
 {
 	union {
@@ -587,7 +1751,14 @@ void do_wordlist_crack(struct db_main *db, char *name, int rules)
 #endif
 	char msg_buf[128];
 	int forceLoad = 0;
+#if HAVE_PTHREAD
+	int use_pipeline, pipelined;
+#endif
+#ifdef _OPENMP
+	int use_omp_rules;
+#endif
 	int dupeCheck = (options.flags & FLG_DUPESUPP) ? 1 : 0;
+	int dupe_ppm = 0;
 	int loopBack = (options.flags & FLG_LOOPBACK_CHK) ? 1 : 0;
 	int do_lmloop = loopBack && db->plaintexts->head;
 	long my_size = 0;
@@ -627,8 +1798,20 @@ void do_wordlist_crack(struct db_main *db, char *name, int rules)
 	if (loopBack && !name)
 		name = options.wordlist = options.activepot;
 
+	/* The loader may have kept its plaintexts for us already */
+	loop_list = NULL;
+	loop_last = NULL;
+	loop_words_size = 0;
+	if (loopBack && db->loopback && !(options.flags & FLG_EXTERNAL_CHK))
+		loop_list = db->loopback;
+
+	/* A wordlist too large to be loaded may be filtered as it's read */
+	if (dupeCheck && !loopBack)
+		dupe_ppm = cfg_get_int(SECTION_OPTIONS, NULL,
+		                       "DupeSuppressionFilterPPM");
+
 	/* These will ignore --save-memory */
-	if (loopBack || dupeCheck ||
+	if (loopBack || (dupeCheck && dupe_ppm <= 0) ||
 	    (!options.max_wordfile_memory &&
 	     (options.flags & FLG_RULES)))
 		forceLoad = 1;
@@ -650,12 +1833,19 @@ void do_wordlist_crack(struct db_main *db, char *name, int rules)
 	if (options.flags & FLG_STACKED)
 		options.max_fix_state_delay = 0;
 
+	wq_parts = 0;
+	if (workq_chunks && name && !loopBack && !f_new &&
+	    !(options.flags & FLG_STACKED)) {
+		wq_parts = workq_chunks * options.fork;
+	}
+
 	if (name) {
 		char *cp, csearch;
 		int64_t ourshare = 0;
 
 		if (!(word_file = jtr_fopen(path_expand(name), "rb")))
 			pexit(STR_MACRO(jtr_fopen)": %s", path_expand(name));
+		setvbuf(word_file, NULL, _IOFBF, WORDLIST_STDIO_BUFFER);
 		log_event("- %s file: %.100s",
 		          loopBack ? "Loopback pot" : "Wordlist",
 		          path_expand(name));
@@ -671,8 +1861,26 @@ void do_wordlist_crack(struct db_main *db, char *name, int rules)
 			error();
 		}
 
+#if WL_COMPRESSED
+		if (!loopBack && (i = zwl_detect(word_file))) {
+			log_event("- %s compressed, decompressing in a thread of "
+			          "its own", i == ZWL_GZIP ? "gzip" : "bzip2");
+			zwl_open(word_file, i, file_len);
+/*
+ * Whether it'd be loaded depends on its decompressed size, which we don't
+ * know without decompressing it.
+ */
+			if (forceLoad || dupeCheck ||
+			    (mem_saving_level < 2 && (options.flags & FLG_RULES)))
+				file_len = zwl_count(forceLoad || dupeCheck ? 0 :
+				    (int64_t)options.max_wordfile_memory *
+				    MAX(options.node_count, 1));
+		}
+#endif
+
 #ifdef HAVE_MMAP
-		if (cfg_get_bool(SECTION_OPTIONS, NULL, "WordlistMemoryMap", 1))
+		if (!wl_compressed && !loop_list &&
+		    cfg_get_bool(SECTION_OPTIONS, NULL, "WordlistMemoryMap", 1))
 		{
 			log_event("- memory mapping wordlist ("LLd" bytes)",
 			          (long long)file_len);
@@ -703,7 +1911,7 @@ void do_wordlist_crack(struct db_main *db, char *name, int rules)
 		}
 #endif
 
-		ourshare = options.node_count ?
+		ourshare = (options.node_count && !wq_parts) ?
 			(file_len / options.node_count) *
 			(options.node_max - options.node_min + 1)
 			: file_len;
@@ -713,14 +1921,111 @@ void do_wordlist_crack(struct db_main *db, char *name, int rules)
 		    (options.flags & FLG_RULES))
 			forceLoad = 1;
 
+		if (rec_restoring_now) {
+			rec_peek(scan_state);
+		} else {
+			word_major = cfg_get_bool(SECTION_OPTIONS, NULL,
+			    "RulesWordMajor", 0);
+			wl_slices = cfg_get_bool(SECTION_OPTIONS, NULL,
+			    "WordlistIndex", 0);
+		}
+		if (forceLoad || !rules || loopBack || f_new || dupeCheck ||
+		    wl_compressed || (options.flags & (FLG_EXTERNAL_CHK | FLG_STACKED)))
+			word_major = 0;
+
+		if (word_major) {
+#ifdef HAVE_MMAP
+			if (mem_map) {
+				munmap(mem_map, file_len);
+				mem_map = map_pos = map_end = NULL;
+			}
+#endif
+			if (options.max_wordfile_memory < 0x20000)
+				options.max_wordfile_memory = 0x20000;
+			if (length < 16)
+				max_block_words =
+				    options.max_wordfile_memory / length;
+			else
+				max_block_words =
+				    options.max_wordfile_memory / 16;
+			log_event("- Word-major rules, reading wordlist in "
+			          "blocks of up to "Zu" bytes",
+			          options.max_wordfile_memory);
+
+			word_file_str =
+				mem_alloc_tiny(options.max_wordfile_memory,
+				               MEM_ALIGN_NONE);
+			words = mem_alloc(max_block_words * sizeof(char*));
+			block_file_len = file_len;
+		}
+
+		map_start = mem_map;
+		first_line = 0;
+		map_ahead = 0;
+		if (!forceLoad && !word_major) {
+#if defined(HAVE_MMAP) && defined(MADV_SEQUENTIAL)
+			if (mem_map)
+				madvise(mem_map, file_len, MADV_SEQUENTIAL);
+#endif
+#ifdef POSIX_FADV_SEQUENTIAL
+			if (!mem_map && !wl_compressed)
+				posix_fadvise(fileno(word_file), 0, 0,
+				    POSIX_FADV_SEQUENTIAL);
+#endif
+		}
+		if (mem_map && !forceLoad && (wl_slices ||
+		    cfg_get_bool(SECTION_OPTIONS, NULL, "WordlistIndex", 0)))
+			wl_index_open(path_expand(name));
+
+		if (dupeCheck && !forceLoad) {
+			uint64_t lines = file_len / 8;
+
+			if (wl_index) {
+				lines = wl_index_lines;
+#if WL_COMPRESSED
+			} else if (zwl.type) {
+				lines = zwl.lines;
+#endif
+			} else if (mem_map) {
+				char *p = mem_map;
+
+				lines = 0;
+				while ((p = memchr(p, '\n', map_end - p))) {
+					lines++;
+					p++;
+				}
+			}
+			if (wq_parts) {
+				log_event("- Dynamic work distribution is not "
+				          "used with dupe suppression");
+				wq_parts = 0;
+			}
+			wl_slices = 0;
+			if (!rules) {
+				dupe_truncate = length;
+				dupe_minlength = minlength;
+				dupe_maxlength = maxlength;
+			}
+			dupe_init(lines + 1, MIN(dupe_ppm, 100000));
+		}
+
+		if (wq_parts)
+			wl_slices = 0;
+
 		/* If it's worth it we make a ready-to-use buffer with the
 		   (possibly converted) contents ready to use as an array.
 		   Disabled for external filter - it would trash the buffer. */
+		if (loop_list) {
+			log_event("- using the %d plaintexts loaded from the "
+			          "pot file", loop_list->count);
+			nWordFileLines = 0;
+			loopback_update(rules, length, minlength, maxlength);
+		} else
 		if (!(options.flags & FLG_EXTERNAL_CHK) && forceLoad) {
 			char *aep;
 
 			// Load only this node's share of words to memory
-			if (mem_map && options.node_count > 1 &&
+			if (mem_map && options.node_count > 1 && !wq_parts &&
 			    (file_len > options.node_count * (length * 100))) {
 				/* Check net size for our share. */
 				for (nWordFileLines = 0;; ++nWordFileLines) {
@@ -1061,6 +2366,12 @@ SKIP_MEM_MAP_LOAD:
 		}
 	}
 
+	if (wq_parts && !nWordFileLines && !mem_map) {
+		log_event("- Dynamic work distribution needs the wordlist "
+		          "in memory or memory mapped, not used");
+		wq_parts = 0;
+	}
+
 REDO_AFTER_LMLOOP:
 
 	if (rules) {
@@ -1076,6 +2387,8 @@ REDO_AFTER_LMLOOP:
 
 		rules_init(rules_length);
 		rule_count = rules_count(&ctx, -1);
+		if (wq_parts)
+			wq_rule_start = ctx;
 
 		if (do_lmloop || !db->plaintexts->head)
 		log_event("- %d preprocessed word mangling rules", rule_count);
@@ -1090,6 +2403,21 @@ REDO_AFTER_LMLOOP:
 		apply = dummy_rules_apply;
 	}
 
+#if HAVE_PTHREAD
+	use_pipeline = rules && !f_filter && !f_new && !options.mask &&
+#if HAVE_REXGEN
+		!regex &&
+#endif
+		cfg_get_bool(SECTION_OPTIONS, NULL, "RulesPipeline", 0);
+#endif
+#ifdef _OPENMP
+/*
+ * With a format that uses OpenMP, the threads would otherwise sit idle while
+ * we apply the rules, so have them do that too.
+ */
+	use_omp_rules = db->format->params.flags & FMT_OMP;
+#endif
+
 	rule_number = 0;
 	line_number = 0;
 	loop_line_no = 0;
@@ -1113,6 +2441,11 @@ REDO_AFTER_LMLOOP:
 	if (rules)
 		prerule = rpp_next(&ctx);
 
+	if (word_major && !(nWordFileLines = read_block())) {
+		prerule = NULL;
+		rules = 0;
+	}
+
 /* A string that can't be produced by fgetl(). */
 	last[0] = '\n';
 	last[1] = 0;
@@ -1123,7 +2456,7 @@ REDO_AFTER_LMLOOP:
 	their_words = 0;
 	/* myWordFileLines indicates we already have OUR share of words in
 	   memory buffer, so no further skipping. */
-	if (options.node_count && !myWordFileLines) {
+	if (options.node_count && !myWordFileLines && !wq_parts) {
 		int rule_rem = rule_count % options.node_count;
 		const char *now, *later = "";
 		dist_switch = rule_count - rule_rem;
@@ -1137,6 +2470,16 @@ REDO_AFTER_LMLOOP:
 			my_words = options.node_max - options.node_min + 1;
 			their_words = options.node_count - my_words;
 			now = "words";
+			if (mem_map && !nWordFileLines &&
+			    set_slice(file_len)) {
+				my_words = ~0UL;
+				their_words = 0;
+				now = "slices of the wordlist";
+				if (!line_number) {
+					line_number = first_line;
+					map_pos = map_start;
+				}
+			}
 		}
 		log_event("- Will distribute %s across nodes%s", now, later);
 	}
@@ -1169,6 +2512,10 @@ REDO_AFTER_LMLOOP:
 	do {
 		struct list_entry *joined;
 
+next_chunk:
+		if (wq_parts && wq_next_chunk())
+			break;
+
 		if (rules) {
 			if (dist_rules) {
 				int for_node =
@@ -1193,10 +2540,25 @@ REDO_AFTER_LMLOOP:
 				if (options.verbosity >= VERB_LEGACY)
 				log_event("- Rule #%d: '%.100s' rejected",
 					rule_number + 1, prerule);
+				if (wq_parts) {
+					workq_skip();
+					goto next_chunk;
+				}
 				goto next_rule;
 			}
 		}
 
+		batch_count = batch_pos = 0;
+		batch_rules = 0;
+		if (rules && nWordFileLines) {
+			if (rules_batch_ok(rule))
+				batch_rules = BATCH_SIMD;
+#ifdef _OPENMP
+			else if (use_omp_rules && rules_parallel_ok(rule))
+				batch_rules = BATCH_OMP;
+#endif
+		}
+
 		/* Process loopback LM passwords that were put together
 		   at start of session */
 		if (rule && do_lmloop && (joined = db->plaintexts->head))
@@ -1261,9 +2623,38 @@ REDO_AFTER_LMLOOP:
 			}
 		} while ((joined = joined->next));
 
+#if HAVE_PTHREAD
+		else if (rule && nWordFileLines && use_pipeline &&
+		         (pipelined = pipeline_process(rule, &last,
+		             wq_parts ? wq_end : nWordFileLines,
+		             options.node_count && !myWordFileLines &&
+		             !wq_parts && !dist_rules)) >= 0) {
+			if (pipelined) {
+				rule = NULL;
+				rules = 0;
+				pipe_input = 0;
+			}
+		}
+#endif
+
 		else if (rule && nWordFileLines)
-		while (line_number < nWordFileLines) {
-			if (options.node_count && !myWordFileLines)
+		while (batch_pos < batch_count ||
+		       line_number < (wq_parts ? wq_end : nWordFileLines)) {
+			if (batch_pos < batch_count) {
+				line_number = batch_line[batch_pos];
+				if ((word = batch_out[batch_pos++]))
+					goto process_batch_word;
+				continue;
+			}
+			if (batch_rules) {
+				batch_count = apply_batch(rule, last,
+				    wq_parts ? wq_end : nWordFileLines,
+				    options.node_count && !myWordFileLines &&
+				    !wq_parts && !dist_rules);
+				batch_pos = 0;
+				continue;
+			}
+			if (options.node_count && !myWordFileLines && !wq_parts)
 			if (!dist_rules) {
 				int for_node = line_number %
 					options.node_count + 1;
@@ -1284,6 +2675,7 @@ REDO_AFTER_LMLOOP:
 			line_number++;
 
 			if ((word = apply(line, rule, -1, last))) {
+process_batch_word:
 				last = word;
 #if HAVE_REXGEN
 				if (regex) {
@@ -1320,6 +2712,7 @@ REDO_AFTER_LMLOOP:
 				} else
 				if (ext_filter(word))
 				if (crk_process_key(word)) {
+					rule = NULL;
 					rules = 0;
 					pipe_input = 0;
 					break;
@@ -1327,10 +2720,15 @@ REDO_AFTER_LMLOOP:
 			}
 		}
 
-		else if (rule)
-		while (mem_map ? mgetl(line) :
+		else if (rule && !loop_list)
+		while (mem_map ?
+		       (wq_parts && map_pos >= mem_map + wq_end ?
+		        NULL : mgetl(line)) :
 		       fgetl(line, LINE_BUFFER_SIZE, word_file)) {
 
+			if (mem_map)
+				map_read_ahead();
+
 			clean_bom(line);
 
 			line_number++;
@@ -1358,6 +2756,9 @@ process_word:
 						goto next_word;
 				}
 
+				if (dupe_filter && dupe_seen(line))
+					goto next_word;
+
 				if ((word = apply(line, rule, -1, last))) {
 					if (rules)
 						last = word;
@@ -1397,6 +2798,7 @@ process_word:
 					} else
 					if (ext_filter(word))
 					if (crk_process_key(word)) {
+						rule = NULL;
 						rules = 0;
 						pipe_input = 0;
 						break;
@@ -1419,11 +2821,28 @@ next_word:
 		if (ferror(word_file))
 			break;
 
+		if (wq_parts && rule)
+			goto next_chunk;
+
 #if HAVE_WINDOWS_H
 EndOfFile:
 #endif
 		if (rules) {
 next_rule:
+			if (dist_rules) {
+/* Skip other nodes' rules without producing them */
+				int skip = (options.node_min - 1 -
+				    (rule_number + 1) % options.node_count +
+				    options.node_count) % options.node_count;
+
+				if (skip > options.node_count -
+				    (options.node_max - options.node_min + 1))
+					skip = 0;
+				if (skip > dist_switch - rule_number - 1)
+					skip = MAX(dist_switch - rule_number - 1, 0);
+				if (skip && rpp_skip(&ctx, skip)) break;
+				rule_number += skip;
+			}
 			if (!(rule = rpp_next(&ctx))) break;
 			rule_number++;
 
@@ -1434,15 +2853,24 @@ next_rule:
 				my_words =
 				    options.node_max - options.node_min + 1;
 				their_words = options.node_count - my_words;
+				if (mem_map && !nWordFileLines &&
+				    set_slice(file_len)) {
+					my_words = ~0UL;
+					their_words = 0;
+				}
 			}
 
-			line_number = 0;
+			line_number = first_line;
+			if (loop_list)
+				loopback_update(rules, length, minlength,
+				    maxlength);
+			if (dupe_filter)
+				memset(dupe_filter, 0, dupe_filter_size);
 			if (!nWordFileLines && word_file != stdin) {
 				if (mem_map)
-					map_pos = mem_map;
+					map_pos = map_start;
 				else
-				if (jtr_fseek64(word_file, 0, SEEK_SET))
-					pexit(STR_MACRO(jtr_fseek64));
+					rewind_word_file();
 			}
 			if (their_words &&
 			    skip_lines(options.node_min - 1, line))
@@ -1461,6 +2889,9 @@ next_rule:
 	if (pipe_input)
 		goto GRAB_NEXT_PIPE_LOAD;
 
+	if (word_major && rules && !event_abort)
+		goto REDO_AFTER_LMLOOP;
+
 	crk_done();
 	rec_done(event_abort || (status.pass && db->salts));
 
@@ -1480,6 +2911,13 @@ next_rule:
 		if (mem_map)
 			munmap(mem_map, file_len);
 		map_pos = map_end = NULL;
+		MEM_FREE(wl_index);
+#endif
+		MEM_FREE(dupe_filter);
+#if WL_COMPRESSED
+		if (zwl.type)
+			zwl_close();
+		else
 #endif
 		if (fclose(word_file))
 			pexit("fclose");
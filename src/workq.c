@@ -0,0 +1,305 @@
+/*
+ * This file is part of John the Ripper password cracker.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted.
+ *
+ * There's ABSOLUTELY NO WARRANTY, express or implied.
+ */
+
+#if AC_BUILT
+#include "autoconfig.h"
+#endif
+
+#define NEED_OS_FORK
+#include "os.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#if OS_FORK
+#include <sys/mman.h>
+#endif
+
+#include "arch.h"
+#include "misc.h"
+#include "params.h"
+#include "path.h"
+#include "memory.h"
+#include "config.h"
+#include "options.h"
+#include "logger.h"
+#include "recovery.h"
+#include "workq.h"
+#include "memdbg.h"
+
+#define WORKQ_IDLE			(~(uint64_t)0)
+
+unsigned int workq_chunks;
+
+#if OS_FORK
+/*
+ * The only state shared between the processes.  claiming[] has a slot per
+ * process, holding a lower bound on the chunks that process has claimed but
+ * not yet written to its crash recovery file (or WORKQ_IDLE), so that a file
+ * written meanwhile by anyone does not claim those have been handed out for
+ * good.
+ */
+static struct {
+	volatile uint64_t next;
+	volatile uint64_t claiming[1];
+} *shared;
+#endif
+
+/*
+ * Any chunk below this one has either been completed or is listed in some
+ * process' crash recovery file.  When restoring, that's the maximum of what
+ * all of the processes' files say.
+ */
+static uint64_t restored_next;
+
+/* Chunks handed to this process but not known to be completely processed */
+static uint64_t *pending;
+static unsigned int pending_count, pending_size;
+/* Whether the mode's saved position is within pending[0] */
+static int positioned;
+
+/* Restored chunks not yet handed back to the mode */
+static uint64_t *todo;
+static unsigned int todo_count, todo_pos;
+static int todo_positioned;
+
+static int read_block(FILE *file, unsigned int *chunks, uint64_t *next,
+	int *pos, unsigned int *count, uint64_t **list)
+{
+	unsigned long long ull;
+	unsigned int i;
+
+	if (fscanf(file, "%u\n" LLu "\n%d\n%u\n", chunks, &ull, pos,
+	    count) != 4 || !*chunks || *count > 0x1000000)
+		return 1;
+	*next = ull;
+
+	*list = mem_alloc_tiny((*count + 1) * sizeof(**list),
+	    sizeof(**list));
+	for (i = 0; i < *count; i++) {
+		if (fscanf(file, LLu "\n", &ull) != 1)
+			return 1;
+		(*list)[i] = ull;
+	}
+
+	return 0;
+}
+
+#if OS_FORK
+static int scan_found;
+
+static void scan_file(FILE *file)
+{
+	char buf[128];
+	unsigned int chunks, count;
+	uint64_t next, *list;
+	int pos;
+
+	fgetl(buf, sizeof(buf), file);
+	while (!feof(file)) {
+		if (!strcmp(buf, "wrk-v1")) {
+			if (read_block(file, &chunks, &next, &pos, &count,
+			    &list)) {
+				fprintf(stderr, "Incorrect crash recovery file "
+				    "format (work distribution)\n");
+				error();
+			}
+			if (!scan_found) {
+				workq_chunks = chunks;
+				restored_next = next;
+			} else if (next > restored_next)
+				restored_next = next;
+			scan_found = 1;
+			return;
+		}
+		fgetl(buf, sizeof(buf), file);
+	}
+}
+#endif
+
+void workq_init(void)
+{
+#if OS_FORK
+	size_t size;
+	unsigned int i;
+	int value;
+
+	workq_chunks = 0;
+
+	if (!options.fork)
+		return;
+
+	if (rec_restoring_now) {
+/*
+ * Whether to use dynamic distribution or not is decided by the session being
+ * restored, regardless of what john.conf says now.
+ */
+		rec_peek(scan_file);
+		if (!scan_found)
+			return;
+		for (i = options.node_min + 1; i <= options.node_max; i++) {
+			char suffix[1 + 20 + sizeof(RECOVERY_SUFFIX)];
+			FILE *file;
+
+			sprintf(suffix, ".%u%s", i, RECOVERY_SUFFIX);
+			if (!(file = fopen(path_session(rec_name, suffix),
+			    "r")))
+				continue;
+			scan_file(file);
+			fclose(file);
+		}
+	} else {
+		if ((value = cfg_get_int(SECTION_OPTIONS, NULL,
+		    "ForkWorkChunks")) <= 0)
+			return;
+		workq_chunks = value;
+	}
+
+	if (options.node_min != 1 || options.node_max != options.node_count) {
+		log_event("- Dynamic work distribution needs all nodes in one "
+		    "process group, not used");
+		workq_chunks = 0;
+		return;
+	}
+
+	size = sizeof(*shared) + (options.fork - 1) * sizeof(uint64_t);
+	shared = mmap(NULL, size, PROT_READ | PROT_WRITE,
+#ifdef MAP_ANON
+	    MAP_SHARED | MAP_ANON,
+#else
+	    MAP_SHARED | MAP_ANONYMOUS,
+#endif
+	    -1, 0);
+	if (shared == MAP_FAILED) {
+		log_event("- Dynamic work distribution: mmap: %s",
+		    strerror(errno));
+		shared = NULL;
+		workq_chunks = 0;
+		return;
+	}
+
+	shared->next = restored_next;
+	for (i = 0; i < options.fork; i++)
+		shared->claiming[i] = WORKQ_IDLE;
+
+	log_event("- Dynamic work distribution, %u chunks per process",
+	    workq_chunks);
+#endif
+}
+
+uint64_t workq_next(int *resumed)
+{
+	uint64_t chunk;
+
+	*resumed = 0;
+
+	if (todo_pos < todo_count) {
+		*resumed = !todo_pos && todo_positioned;
+		chunk = todo[todo_pos++];
+	} else {
+#if OS_FORK
+		volatile uint64_t *slot =
+		    &shared->claiming[options.node_min - 1];
+
+		if (*slot == WORKQ_IDLE) {
+			*slot = shared->next;
+			__sync_synchronize();
+		}
+		chunk = __sync_fetch_and_add(&shared->next, 1);
+#else
+		chunk = 0;
+#endif
+	}
+
+	if (pending_count >= pending_size) {
+		pending_size = pending_size ? pending_size * 2 : 8;
+		pending = mem_realloc(pending,
+		    pending_size * sizeof(*pending));
+	}
+	if (!pending_count)
+		positioned = *resumed;
+	pending[pending_count++] = chunk;
+
+	return chunk;
+}
+
+void workq_skip(void)
+{
+	if (pending_count && !--pending_count)
+		positioned = 0;
+}
+
+void workq_fix_state(void)
+{
+	if (!pending_count)
+		return;
+
+	pending[0] = pending[pending_count - 1];
+	pending_count = 1;
+	positioned = 1;
+}
+
+void workq_save_state(FILE *file)
+{
+	uint64_t next = 0;
+	unsigned int i;
+
+#if OS_FORK
+	next = shared->next;
+	__sync_synchronize();
+	for (i = 0; i < options.fork; i++)
+		if (i != options.node_min - 1 && shared->claiming[i] < next)
+			next = shared->claiming[i];
+#endif
+
+/*
+ * Our own claims are all in the list below, completed ones excepted, and so
+ * are the restored chunks we haven't got to yet.
+ */
+	fprintf(file, "wrk-v1\n%u\n" LLu "\n%d\n%u\n", workq_chunks,
+	    (unsigned long long)next, positioned,
+	    pending_count + todo_count - todo_pos);
+	for (i = 0; i < pending_count; i++)
+		fprintf(file, LLu "\n", (unsigned long long)pending[i]);
+	for (i = todo_pos; i < todo_count; i++)
+		fprintf(file, LLu "\n", (unsigned long long)todo[i]);
+}
+
+void workq_saved(void)
+{
+#if OS_FORK
+	__sync_synchronize();
+	shared->claiming[options.node_min - 1] = WORKQ_IDLE;
+#endif
+}
+
+int workq_restore_state(FILE *file)
+{
+	unsigned int chunks, i, j;
+	uint64_t next;
+
+	if (read_block(file, &chunks, &next, &todo_positioned, &todo_count,
+	    &todo))
+		return 1;
+
+/*
+ * Chunks at or above the shared counter will be handed out again, to
+ * whoever gets there first.  We just lose the progress made on them.
+ */
+	for (i = j = 0; i < todo_count; i++)
+		if (todo[i] < restored_next)
+			todo[j++] = todo[i];
+		else if (!i)
+			todo_positioned = 0;
+	todo_count = j;
+	todo_pos = 0;
+
+	return 0;
+}
@@ -0,0 +1,67 @@
+/*
+ * This file is part of John the Ripper password cracker.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted.
+ *
+ * There's ABSOLUTELY NO WARRANTY, express or implied.
+ */
+
+/*
+ * Dynamic work distribution for --fork sessions.
+ *
+ * Instead of every child getting a fixed share of the keyspace, cracking
+ * modes split their work into small chunks and the processes grab the next
+ * chunk from a counter kept in shared memory whenever they are done with the
+ * previous one.  Chunk numbers are mode-specific, but always increasing.
+ */
+
+#ifndef _JOHN_WORKQ_H
+#define _JOHN_WORKQ_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ * Number of chunks per process for each unit of work (eg. per rule in
+ * wordlist mode), or zero if dynamic distribution is not in use.
+ */
+extern unsigned int workq_chunks;
+
+/*
+ * Called by john_fork() in the parent, before forking.  Decides whether
+ * dynamic distribution is to be used (from john.conf for new sessions, from
+ * the crash recovery files for restored ones) and sets up the shared counter.
+ */
+extern void workq_init(void);
+
+/*
+ * Returns the next chunk number for this process.  After a restore, the
+ * chunks that were in progress are returned first; *resumed is set for the
+ * one the restored mode position points into (that is, the cracking mode
+ * should not seek to its start).
+ */
+extern uint64_t workq_next(int *resumed);
+
+/*
+ * Tells that the chunk last returned turned out to have nothing to process
+ * (eg. its rule was rejected), so it needn't be kept in the recovery file.
+ */
+extern void workq_skip(void);
+
+/*
+ * To be called along with the cracking mode's fix_state(): all candidates
+ * generated so far have been processed, so only the current chunk remains
+ * in progress.
+ */
+extern void workq_fix_state(void);
+
+/*
+ * Crash recovery file support, called from recovery.c.  workq_saved() is
+ * called once what workq_save_state() wrote has made it to the file.
+ */
+extern void workq_save_state(FILE *file);
+extern void workq_saved(void);
+extern int workq_restore_state(FILE *file);
+
+#endif